@@ -1,7 +1,7 @@
 #include <iostream>
 #include <vector>
 #include <string>
-#include <map>
+#include <unordered_map>
 #include <iomanip>
 #include <cmath>
 #include <chrono>
@@ -10,12 +10,26 @@
 #include <algorithm>
 #include <memory>
 #include <fstream>
+#include <cstdint>
+#include <cstring>
+#include <cctype>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <sys/stat.h>
+#include "plate_key.h"
 
 // ==================== CONSTANTS & ENUMS ====================
 const double CAR_HOURLY_RATE = 20.0;
 const double BIKE_HOURLY_RATE = 10.0;
 const double DAILY_MAX = 200.0;
 const double MIN_CHARGE_HOURS = 1.0;
+const int SERVICE_DUE_SOON_DAYS = 7;          // warn this many days before a service is due
+const int SERVICE_DUE_REFRESH_SECONDS = 2;    // how often the service-due file is checked
+const char SERVICE_DUE_MAGIC[4] = {'V', 'S', 'R', 'R'};   // DUE_FILE_MAGIC in the service system
+const uint32_t SERVICE_DUE_VERSION = 1;
 
 enum class VehicleType { CAR, BIKE, HANDICAPPED, ELECTRIC };
 enum class SlotStatus { FREE, OCCUPIED, RESERVED, MAINTENANCE };
@@ -193,16 +207,198 @@ public:
     int getTotalSlots() const { return slots.size(); }
 };
 
+// ==================== PLATE KEYS ====================
+// "ab 12 cd 3456", "AB12CD3456" and "AB-12-CD-3456" are one vehicle. Every
+// plate is reduced to the same key the service record system uses, by the
+// same code (plate_key.h), with its hash computed once.
+struct PlateKey {
+    char bytes[PLATE_KEY_SIZE];
+    uint64_t hash;
+
+    bool operator==(const PlateKey& other) const {
+        return std::memcmp(bytes, other.bytes, PLATE_KEY_SIZE) == 0;
+    }
+    std::string str() const { return bytes; }
+};
+
+struct PlateKeyHash {
+    size_t operator()(const PlateKey& key) const { return static_cast<size_t>(key.hash); }
+};
+
+PlateKey normalizePlate(const char* plate) {
+    PlateKey key;
+    key.hash = plateKeyFrom(plate, key.bytes);
+    return key;
+}
+
+PlateKey normalizePlate(const std::string& plate) { return normalizePlate(plate.c_str()); }
+
+// ==================== SERVICE DUE LOOKUP ====================
+// Plate -> last service and next due day, read from the "<records>.due" file
+// the service record system rewrites on every save. A loaded table is never
+// modified: a background thread builds a new one when the file changes and
+// swaps it in, so a lookup at the gate never waits on a reload.
+
+// Days since 01-01-1970 for a civil date (proleptic Gregorian)
+int64_t dayNumber(int year, int month, int day) {
+    year -= month <= 2;
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    int64_t yearOfEra = year - era * 400;
+    int64_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    return era * 146097 + yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear - 719468;
+}
+
+int64_t todayDayNumber() {
+    std::time_t now = std::time(nullptr);
+    std::tm* tm = std::localtime(&now);
+    return dayNumber(tm->tm_year + 1900, tm->tm_mon + 1, tm->tm_mday);
+}
+
+std::string formatDayNumber(int64_t days) {
+    std::time_t time = static_cast<std::time_t>(days) * 86400;
+    std::tm* tm = std::gmtime(&time);
+    std::stringstream ss;
+    ss << std::put_time(tm, "%d-%m-%Y");
+    return ss.str();
+}
+
+struct ServiceDueEntry {         // layout of one record in the .due file
+    char plate[20];
+    int32_t lastServiceDay;
+    int32_t dueDay;
+};
+
+class ServiceDueTable {
+private:
+    std::vector<ServiceDueEntry> entries;
+    std::vector<int32_t> slots;  // open addressing, entry index or -1
+    size_t mask = 0;
+
+public:
+    explicit ServiceDueTable(std::vector<ServiceDueEntry> loaded) : entries(std::move(loaded)) {
+        size_t capacity = 16;
+        while (capacity < entries.size() * 2) capacity *= 2;
+        slots.assign(capacity, -1);
+        mask = capacity - 1;
+        for (size_t i = 0; i < entries.size(); ++i) {
+            entries[i].plate[sizeof(entries[i].plate) - 1] = '\0';
+            PlateKey key = normalizePlate(entries[i].plate);
+            std::memcpy(entries[i].plate, key.bytes, sizeof(entries[i].plate));
+            size_t slot = key.hash & mask;
+            while (slots[slot] >= 0) slot = (slot + 1) & mask;
+            slots[slot] = static_cast<int32_t>(i);
+        }
+    }
+
+    const ServiceDueEntry* find(const PlateKey& plate) const {
+        for (size_t slot = plate.hash & mask; slots[slot] >= 0; slot = (slot + 1) & mask) {
+            const ServiceDueEntry& entry = entries[slots[slot]];
+            if (std::memcmp(plate.bytes, entry.plate, PLATE_KEY_SIZE) == 0) return &entry;
+        }
+        return nullptr;
+    }
+
+    size_t size() const { return entries.size(); }
+};
+
+class ServiceDueDirectory {
+private:
+    std::string path;
+    std::shared_ptr<const ServiceDueTable> table;   // read and swapped with std::atomic_load/store
+    struct timespec loadedMtime = {0, 0};
+    off_t loadedSize = -1;
+    std::thread refresher;
+    std::mutex stopLock;
+    std::condition_variable stopSignal;
+    bool stopping = false;
+
+    // Read the file into a new table; nullptr if it is missing or damaged
+    std::shared_ptr<const ServiceDueTable> load() const {
+        std::ifstream in(path, std::ios::binary);
+        char magic[4];
+        uint32_t version = 0;
+        uint64_t count = 0;
+        if (!in.read(magic, 4) || std::memcmp(magic, SERVICE_DUE_MAGIC, 4) != 0 ||
+            !in.read(reinterpret_cast<char*>(&version), sizeof(version)) || version != SERVICE_DUE_VERSION ||
+            !in.read(reinterpret_cast<char*>(&count), sizeof(count)))
+            return nullptr;
+        // The entries fill the rest of the file; a damaged count must not size the vector
+        std::streamoff start = in.tellg();
+        if (start < 0 || !in.seekg(0, std::ios::end)) return nullptr;
+        std::streamoff end = in.tellg();
+        if (end < start || (end - start) % sizeof(ServiceDueEntry) != 0 ||
+            count != static_cast<uint64_t>(end - start) / sizeof(ServiceDueEntry) || !in.seekg(start))
+            return nullptr;
+        std::vector<ServiceDueEntry> entries(count);
+        if (count > 0 && !in.read(reinterpret_cast<char*>(entries.data()), count * sizeof(ServiceDueEntry)))
+            return nullptr;
+        return std::make_shared<const ServiceDueTable>(std::move(entries));
+    }
+
+    void refreshLoop() {
+        std::unique_lock<std::mutex> lock(stopLock);
+        while (!stopSignal.wait_for(lock, std::chrono::seconds(SERVICE_DUE_REFRESH_SECONDS),
+                                    [this] { return stopping; })) {
+            lock.unlock();
+            refresh();
+            lock.lock();
+        }
+    }
+
+public:
+    explicit ServiceDueDirectory(const std::string& file) : path(file) {
+        refresh();
+        refresher = std::thread(&ServiceDueDirectory::refreshLoop, this);
+    }
+
+    ~ServiceDueDirectory() {
+        {
+            std::lock_guard<std::mutex> lock(stopLock);
+            stopping = true;
+        }
+        stopSignal.notify_one();
+        refresher.join();
+    }
+
+    // Reload if the file was replaced since the last load; the service
+    // system renames a new copy into place, so a changed file is complete
+    bool refresh() {
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0) return false;
+        if (st.st_size == loadedSize && st.st_mtim.tv_sec == loadedMtime.tv_sec &&
+            st.st_mtim.tv_nsec == loadedMtime.tv_nsec)
+            return false;
+        std::shared_ptr<const ServiceDueTable> loaded;
+        try {
+            loaded = load();
+        } catch (const std::exception&) {
+            // Out of memory building the table: keep serving the current one
+        }
+        if (!loaded) return false;
+        std::atomic_store(&table, loaded);
+        loadedMtime = st.st_mtim;
+        loadedSize = st.st_size;
+        return true;
+    }
+
+    std::shared_ptr<const ServiceDueTable> snapshot() const { return std::atomic_load(&table); }
+};
+
 // ==================== PARKING SYSTEM ====================
 class ParkingSystem {
 private:
     std::vector<ParkingFloor> floors;
-    std::map<std::string, std::shared_ptr<Ticket>> activeTickets;
+    std::unordered_map<PlateKey, std::shared_ptr<Ticket>, PlateKeyHash> activeTickets;
     int ticketCounter = 1000;
     double totalRevenue = 0;
+    const ServiceDueDirectory* serviceDue;
+    int serviceRoutings = 0;
+
+    void checkServiceDue(const PlateKey& plate);
 
 public:
-    ParkingSystem(int numFloors, int carsPerFloor, int bikesPerFloor) {
+    ParkingSystem(int numFloors, int carsPerFloor, int bikesPerFloor, const ServiceDueDirectory* due = nullptr)
+        : serviceDue(due) {
         for (int i = 1; i <= numFloors; ++i)
             floors.emplace_back(i, carsPerFloor, bikesPerFloor);
     }
@@ -221,7 +417,18 @@ void ParkingSystem::parkVehicle() {
     std::cout << "1. Car ($20/hr)\n2. Bike ($10/hr)\nSelect type: ";
     std::cin >> typeChoice;
     std::cout << "Enter Registration Number: ";
-    std::cin >> reg;
+    std::getline(std::cin >> std::ws, reg);
+
+    PlateKey plate = normalizePlate(reg);
+    if (plate.bytes[0] == '\0') {
+        std::cout << "Invalid registration number.\n";
+        return;
+    }
+    if (activeTickets.count(plate)) {
+        std::cout << "Vehicle " << plate.str() << " is already parked.\n";
+        return;
+    }
+    reg = plate.str();
 
     std::unique_ptr<Vehicle> vehicle;
     if (typeChoice == 1) vehicle = std::make_unique<Car>(reg);
@@ -232,20 +439,39 @@ void ParkingSystem::parkVehicle() {
         if (slot && floor.parkVehicle(slot->getId(), std::move(vehicle))) {
             auto ticket = std::make_shared<Ticket>(++ticketCounter, reg,
                 slot->getCurrentVehicle()->getType(), slot->getFloor(), slot->getId());
-            activeTickets[reg] = ticket;
+            activeTickets[plate] = ticket;
             std::cout << "Vehicle parked. Ticket ID: " << ticket->getId() << "\n";
+            checkServiceDue(plate);
             return;
         }
     }
     std::cout << "No slots available.\n";
 }
 
+// Route an admitted vehicle to the service floor when its service is overdue
+void ParkingSystem::checkServiceDue(const PlateKey& plate) {
+    if (!serviceDue) return;
+    auto table = serviceDue->snapshot();
+    if (!table) return;
+    const ServiceDueEntry* entry = table->find(plate);
+    if (!entry) return;
+
+    int64_t today = todayDayNumber();
+    if (entry->dueDay < today) {
+        serviceRoutings++;
+        std::cout << "Service overdue since " << formatDayNumber(entry->dueDay) << " (last service "
+                  << formatDayNumber(entry->lastServiceDay) << "): route to the service floor.\n";
+    } else if (entry->dueDay - today <= SERVICE_DUE_SOON_DAYS) {
+        std::cout << "Service due on " << formatDayNumber(entry->dueDay) << ".\n";
+    }
+}
+
 void ParkingSystem::unparkVehicle() {
     std::string reg;
     std::cout << "\n--- UNPARK VEHICLE ---\nEnter Registration Number: ";
-    std::cin >> reg;
+    std::getline(std::cin >> std::ws, reg);
 
-    auto it = activeTickets.find(reg);
+    auto it = activeTickets.find(normalizePlate(reg));
     if (it == activeTickets.end()) {
         std::cout << "Vehicle not found.\n";
         return;
@@ -272,6 +498,11 @@ void ParkingSystem::displayStatus() const {
     }
     std::cout << "\nTotal Slots: " << total << "\nOccupied: " << occ
               << "\nAvailable: " << total - occ << "\n";
+    if (serviceDue) {
+        auto table = serviceDue->snapshot();
+        std::cout << "Service records known: " << (table ? table->size() : 0)
+                  << "\nRouted to service: " << serviceRoutings << "\n";
+    }
 }
 
 // ==================== MAIN ====================
@@ -280,8 +511,10 @@ void displayMenu() {
     std::cout << "1. Park Vehicle\n2. Unpark Vehicle\n3. View Status\n4. Exit\nSelect option: ";
 }
 
-int main() {
-    ParkingSystem parking(3, 10, 5);
+int main(int argc, char* argv[]) {
+    // The service-due file written by the service record system
+    ServiceDueDirectory serviceDue(argc > 1 ? argv[1] : "service_records.dat.due");
+    ParkingSystem parking(3, 10, 5, &serviceDue);
     int choice;
 
     std::cout << "Welcome to Smart Parking System\n";
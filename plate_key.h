@@ -0,0 +1,176 @@
+// Plate keys, shared by the service record system and the parking program.
+// Plates arrive as "ab 12 cd 3456", "AB12CD3456" or "AB-12-CD-3456"; all
+// of them become the key "AB12CD3456": letters and digits only, letters
+// upper-cased, at most PLATE_KEY_SIZE - 1 characters, zero-padded to
+// PLATE_KEY_SIZE bytes so keys compare with memcmp and hash as fixed words.
+// Builds as C and as C++; each program includes it from one source file.
+#ifndef PLATE_KEY_H
+#define PLATE_KEY_H
+
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#define PLATE_KEY_SIZE 20
+
+static inline uint64_t plateWordsHash(uint64_t a, uint64_t b, uint32_t c) {
+    uint64_t h = a * 0x9E3779B97F4A7C15ULL ^ b * 0xC2B2AE3D27D4EB4FULL ^ c * 0x165667B19E3779F9ULL;
+    h ^= h >> 29;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    return h ^ (h >> 32);
+}
+
+// Hash of a plate key, read as two 64-bit words and a 32-bit tail
+static inline uint64_t plateKeyHash(const char* key) {
+    uint64_t a, b;
+    uint32_t c;
+    memcpy(&a, key, 8);
+    memcpy(&b, key + 8, 8);
+    memcpy(&c, key + 16, 4);
+    return plateWordsHash(a, b, c);
+}
+
+// One character at a time; also used for plates the vector path cannot take
+static inline void normalizePlateScalar(const char* plate, char* key) {
+    char out[PLATE_KEY_SIZE] = { 0 };
+    size_t n = 0;
+    for (; *plate != '\0' && n < PLATE_KEY_SIZE - 1; plate++) {
+        unsigned char c = (unsigned char)*plate;
+        if (c >= 'a' && c <= 'z') c -= 'a' - 'A';
+        if ((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')) out[n++] = (char)c;
+    }
+    memcpy(key, out, PLATE_KEY_SIZE);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+// pshufb controls that pack the kept bytes of an 8-byte group to its front;
+// 0x80 lanes come out zero
+static uint8_t plateShuffle[256][8];
+static pthread_once_t plateShuffleOnce = PTHREAD_ONCE_INIT;
+
+static inline void plateShuffleInit(void) {
+    for (int mask = 0; mask < 256; mask++) {
+        int n = 0;
+        for (int bit = 0; bit < 8; bit++) {
+            if (mask & (1 << bit)) plateShuffle[mask][n++] = (uint8_t)bit;
+        }
+        while (n < 8) plateShuffle[mask][n++] = 0x80;
+    }
+}
+
+// Upper-case 16 bytes in place and return the mask of letters and digits
+__attribute__((target("ssse3,popcnt"), always_inline))
+static inline uint32_t plateUpcase16(__m128i* v) {
+    __m128i lower = _mm_and_si128(_mm_cmpgt_epi8(*v, _mm_set1_epi8('a' - 1)),
+                                  _mm_cmplt_epi8(*v, _mm_set1_epi8('z' + 1)));
+    *v = _mm_sub_epi8(*v, _mm_and_si128(lower, _mm_set1_epi8('a' - 'A')));
+    __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(*v, _mm_set1_epi8('A' - 1)),
+                                  _mm_cmplt_epi8(*v, _mm_set1_epi8('Z' + 1)));
+    __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(*v, _mm_set1_epi8('0' - 1)),
+                                  _mm_cmplt_epi8(*v, _mm_set1_epi8('9' + 1)));
+    return (uint32_t)_mm_movemask_epi8(_mm_or_si128(upper, digit));
+}
+
+// v moved up by n lanes (0 to 16), zero-filled from the bottom
+__attribute__((target("ssse3,popcnt"), always_inline))
+static inline __m128i plateShiftUp(__m128i v, uint32_t n) {
+    __m128i lanes = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    return _mm_shuffle_epi8(v, _mm_sub_epi8(lanes, _mm_set1_epi8((char)n)));
+}
+
+// v moved down by n lanes (0 to 16), zero-filled from the top
+__attribute__((target("ssse3,popcnt"), always_inline))
+static inline __m128i plateShiftDown(__m128i v, uint32_t n) {
+    __m128i control = _mm_add_epi8(_mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+                                   _mm_set1_epi8((char)n));
+    control = _mm_or_si128(control, _mm_cmpgt_epi8(control, _mm_set1_epi8(15)));
+    return _mm_shuffle_epi8(v, control);
+}
+
+// The length (4 to 31) bytes of plate in two registers, zero beyond them.
+// Two overlapping loads cover the string, so no read reaches past its end.
+__attribute__((target("ssse3,popcnt"), always_inline))
+static inline void plateLoad32(const char* plate, uint32_t length, __m128i* lo, __m128i* hi) {
+    *hi = _mm_setzero_si128();
+    if (length >= 16) {
+        *lo = _mm_loadu_si128((const __m128i*)plate);
+        *hi = plateShiftDown(_mm_loadu_si128((const __m128i*)(plate + length - 16)), 32 - length);
+    } else if (length >= 8) {
+        *lo = _mm_or_si128(_mm_loadl_epi64((const __m128i*)plate),
+                           plateShiftUp(_mm_loadl_epi64((const __m128i*)(plate + length - 8)), length - 8));
+    } else {
+        int32_t first, last;
+        memcpy(&first, plate, 4);
+        memcpy(&last, plate + length - 4, 4);
+        *lo = _mm_or_si128(_mm_cvtsi32_si128(first), plateShiftUp(_mm_cvtsi32_si128(last), length - 4));
+    }
+}
+
+// Pack the bytes of v picked by the 16-bit mask keep to the front
+__attribute__((target("ssse3,popcnt"), always_inline))
+static inline __m128i plateCompact16(__m128i v, uint32_t keep, uint32_t* count) {
+    __m128i highLanes = _mm_set_epi64x((long long)0x8080808080808080ULL, 0);
+    uint32_t low = keep & 0xFF, high = keep >> 8, lowCount = (uint32_t)__builtin_popcount(low);
+    __m128i lowControl = _mm_or_si128(_mm_loadl_epi64((const __m128i*)plateShuffle[low]), highLanes);
+    __m128i highControl = _mm_or_si128(_mm_add_epi8(_mm_loadl_epi64((const __m128i*)plateShuffle[high]),
+                                                    _mm_set1_epi8(8)), highLanes);
+    *count = lowCount + (uint32_t)__builtin_popcount(high);
+    return _mm_or_si128(_mm_shuffle_epi8(v, lowControl),
+                        plateShiftUp(_mm_shuffle_epi8(v, highControl), lowCount));
+}
+
+// Whole plate in two 16-byte registers: upper-case and classify every byte
+// at once, then pack the kept bytes without leaving the registers. Returns
+// 0 for plates the scalar path takes: under 4 bytes or over 31.
+__attribute__((target("ssse3,popcnt")))
+static inline int normalizePlateSsse3(const char* plate, char* key, uint64_t* hash) {
+    uint32_t length = (uint32_t)strnlen(plate, 32);
+    if (length < 4 || length == 32) return 0;
+    __m128i lo, hi;
+    plateLoad32(plate, length, &lo, &hi);
+    uint32_t keep = plateUpcase16(&lo) | plateUpcase16(&hi) << 16;
+
+    uint32_t loCount, hiCount;
+    __m128i loPacked = plateCompact16(lo, keep & 0xFFFF, &loCount);
+    __m128i hiPacked = plateCompact16(hi, keep >> 16, &hiCount);
+    __m128i head = _mm_or_si128(loPacked, plateShiftUp(hiPacked, loCount));
+    // Bytes of hiPacked pushed past lane 15 make up the last four key bytes
+    uint32_t tail = (uint32_t)_mm_cvtsi128_si32(plateShiftDown(hiPacked, 16 - loCount));
+    if (loCount + hiCount > PLATE_KEY_SIZE - 1) tail &= 0xFFFFFF;
+
+    _mm_storeu_si128((__m128i*)key, head);
+    memcpy(key + 16, &tail, sizeof(tail));
+    uint64_t first = (uint64_t)_mm_cvtsi128_si64(head);
+    uint64_t second = (uint64_t)_mm_cvtsi128_si64(_mm_srli_si128(head, 8));
+    *hash = plateWordsHash(first, second, tail);
+    return 1;
+}
+
+// SSSE3 and POPCNT present, with the shuffle table built
+static inline int plateVectorReady(void) {
+    static int ready = -1;
+    int state = __atomic_load_n(&ready, __ATOMIC_ACQUIRE);
+    if (state < 0) {
+        state = __builtin_cpu_supports("ssse3") && __builtin_cpu_supports("popcnt");
+        if (state) pthread_once(&plateShuffleOnce, plateShuffleInit);
+        __atomic_store_n(&ready, state, __ATOMIC_RELEASE);
+    }
+    return state;
+}
+#endif
+
+// Write the plate key for a plate as typed or read into key (PLATE_KEY_SIZE
+// bytes; may be the plate's own buffer) and return its hash
+static inline uint64_t plateKeyFrom(const char* plate, char* key) {
+#if defined(__x86_64__) || defined(__i386__)
+    uint64_t hash;
+    if (plateVectorReady() && normalizePlateSsse3(plate, key, &hash)) return hash;
+#endif
+    normalizePlateScalar(plate, key);
+    return plateKeyHash(key);
+}
+
+#endif
@@ -0,0 +1,2155 @@
+// Benchmarks for the Vehicle Service Record System.
+// Builds the record-store code directly, without its interactive menu:
+//   gcc -O2 -o service_bench service_bench.c -lpthread -lm
+//   ./service_bench lsm|memory|bulkadd|cost|costindex|compaction|history|save [records]
+//   ./service_bench query|columns|scan|reminders|shared|plates|merge|shards|io|index|lazy|snapshot [records]
+//   ./service_bench autosave|skiplist|rollups [records]
+//   ./service_bench ops [records]   (10k, 1M and 10M records if not given)
+// The ops suite prints one JSON object per line for run-to-run comparison.
+#define SERVICE_RECORD_NO_MAIN
+#include "Using DSA in C"
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+static const char* benchServiceTypes[] = {
+    "Oil Change", "Brake Service", "Tyre Rotation", "Battery Replacement",
+    "Wheel Alignment", "AC Service", "General Inspection", "Clutch Repair"
+};
+#define BENCH_SERVICE_TYPES (int)(sizeof(benchServiceTypes) / sizeof(benchServiceTypes[0]))
+
+// Monotonic wall-clock time in seconds
+static double benchNow() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Deterministic synthetic plate, e.g. "MH12AB0042"
+static void benchVehicleNumber(uint64_t n, char* out) {
+    static const char* regions[] = { "MH", "DL", "KA", "TN", "GJ", "UP", "WB", "RJ" };
+    snprintf(out, 20, "%s%02d%c%c%04llu", regions[n % 8], (int)(n / 8 % 99) + 1,
+             'A' + (int)(n / 792 % 26), 'A' + (int)(n / 20592 % 26),
+             (unsigned long long)(n % 10000));
+}
+
+// Single puts from several threads, each durable when it returns
+typedef struct BenchLsmWriter {
+    LsmStore* store;
+    long first, count, records;
+} BenchLsmWriter;
+
+static void* benchLsmWriter(void* arg) {
+    BenchLsmWriter* work = (BenchLsmWriter*)arg;
+    char vehicleNumber[20];
+    for (long i = work->first; i < work->first + work->count; i++) {
+        benchVehicleNumber((uint64_t)i * 2654435761ULL % (uint64_t)(work->records * 2), vehicleNumber);
+        lsmPut(work->store, vehicleNumber, "Bench Owner", benchServiceTypes[i % BENCH_SERVICE_TYPES],
+               "01-06-2025", 10000 + i % 90000);
+    }
+    return NULL;
+}
+
+// Sustained write throughput and read amplification of the LSM store.
+// Ingestion writes batches, each synced to the log once; single puts from
+// concurrent writers share syncs through the group commit.
+static void benchLsm(long records) {
+    enum { BATCH = 512, WRITERS = 4 };
+    char prefix[64], vehicleNumber[20];
+    snprintf(prefix, sizeof(prefix), "/tmp/service_bench_lsm.%d", (int)getpid());
+    LsmStore* store = lsmOpen(prefix);
+    if (store == NULL) return;
+    LsmEntry* batch = (LsmEntry*)calloc(BATCH, sizeof(LsmEntry));
+
+    double start = benchNow();
+    for (long i = 0; i < records; i += BATCH) {
+        long n = records - i < BATCH ? records - i : BATCH;
+        for (long j = 0; j < n; j++) {
+            // Spread the keys so runs overlap the way real ingestion does
+            long k = i + j;
+            LsmEntry* entry = &batch[j];
+            benchVehicleNumber((uint64_t)k * 2654435761ULL % (uint64_t)(records * 2), entry->vehicleNumber);
+            snprintf(entry->ownerName, sizeof(entry->ownerName), "Bench Owner");
+            snprintf(entry->serviceType, sizeof(entry->serviceType), "%s",
+                     benchServiceTypes[k % BENCH_SERVICE_TYPES]);
+            snprintf(entry->date, sizeof(entry->date), "%02ld-%02ld-2025", k % 28 + 1, k % 12 + 1);
+            entry->costCents = 10000 + k % 90000;
+        }
+        lsmPutBatch(store, batch, (size_t)n);
+    }
+    double writeSeconds = benchNow() - start;
+    free(batch);
+
+    long singles = records / 100 > WRITERS ? records / 100 : WRITERS;
+    BenchLsmWriter work[WRITERS];
+    pthread_t threads[WRITERS];
+    start = benchNow();
+    for (int t = 0; t < WRITERS; t++) {
+        work[t] = (BenchLsmWriter){ store, singles / WRITERS * t, singles / WRITERS, records };
+        pthread_create(&threads[t], NULL, benchLsmWriter, &work[t]);
+    }
+    for (int t = 0; t < WRITERS; t++) pthread_join(threads[t], NULL);
+    double singleSeconds = benchNow() - start;
+
+    long lookups = records / 10 > 0 ? records / 10 : 1, hits = 0;
+    LsmEntry entry;
+    start = benchNow();
+    for (long i = 0; i < lookups; i++) {
+        benchVehicleNumber((uint64_t)i * 7919 % (uint64_t)(records * 2), vehicleNumber);
+        hits += lsmGet(store, vehicleNumber, &entry);
+    }
+    double readSeconds = benchNow() - start;
+
+    printf("LSM store, %ld writes\n", records);
+    printf("Write throughput: %.0f writes/s in batches of %d\n", records / writeSeconds, BATCH);
+    printf("Single puts from %d threads: %.0f writes/s\n", WRITERS,
+           singles / WRITERS * WRITERS / singleSeconds);
+    printf("Point lookups: %ld (%ld hits), %.0f lookups/s\n", lookups, hits, lookups / readSeconds);
+    lsmPrintStats(store);
+    lsmDrop(store);
+}
+
+// Build a synthetic in-memory store; owners have about three vehicles each
+static ServiceRecord* benchBuildList(long records) {
+    ServiceRecord* head = NULL;
+    char vehicleNumber[20], ownerName[50], serviceType[50], date[11];
+    for (long i = 0; i < records; i++) {
+        benchVehicleNumber((uint64_t)i, vehicleNumber);
+        snprintf(ownerName, sizeof(ownerName), "Customer %ld", i / 3);
+        snprintf(serviceType, sizeof(serviceType), "%s", benchServiceTypes[i % BENCH_SERVICE_TYPES]);
+        snprintf(date, sizeof(date), "%02ld-%02ld-2025", i % 28 + 1, i % 12 + 1);
+        linkRecord(&head, createRecord(vehicleNumber, ownerName, serviceType, date,
+                                       10000 + (int64_t)(i * 7919 % 90000)));
+    }
+    return head;
+}
+
+// Memory and file size per record, inline strings versus interned IDs
+static void benchMemory(long records) {
+    char filename[64];
+    snprintf(filename, sizeof(filename), "/tmp/service_bench_memory.%d.dat", (int)getpid());
+    ServiceRecord* head = benchBuildList(records);
+    saveToFile(head, filename);
+    printMemoryReport(head, filename);
+    freeList(&head);
+
+    char dictPath[80];
+    snprintf(dictPath, sizeof(dictPath), "%s.dict", filename);
+    unlink(filename);
+    unlink(dictPath);
+}
+
+// Register new vehicles in bulk: duplicate check plus link, as addRecord does
+static double benchBulkRegister(long records, double fpRate) {
+    ServiceRecord* head = NULL;
+    char vehicleNumber[20], ownerName[] = "Fleet Customer", serviceType[] = "Oil Change",
+         date[] = "01-01-2025";
+    vehicleFilterConfigure(NULL, fpRate);
+
+    double start = benchNow();
+    for (long i = 0; i < records; i++) {
+        benchVehicleNumber((uint64_t)i, vehicleNumber);
+        if (vehicleExists(head, vehicleNumber)) continue;
+        linkRecord(&head, createRecord(vehicleNumber, ownerName, serviceType, date, 9900));
+    }
+    double seconds = benchNow() - start;
+
+    // Probe vehicles that were never added to measure the real false-positive rate
+    long falsePositives = 0, probes = 100000;
+    if (fpRate > 0) {
+        for (long i = 0; i < probes; i++) {
+            benchVehicleNumber((uint64_t)(records + i), vehicleNumber);
+            falsePositives += vehicleFilterMayContain(vehicleNumber);
+        }
+    }
+    printf("Filter %-8s: %ld inserts in %.3f s, %.0f inserts/s", fpRate > 0 ? "on" : "off",
+           records, seconds, records / seconds);
+    if (fpRate > 0) {
+        printf(", target FP rate %.4f, measured %.4f", fpRate, (double)falsePositives / probes);
+    }
+    printf("\n");
+    freeList(&head);
+    return seconds;
+}
+
+// Float versus integer-cent totals: exactness and throughput
+static void benchCost(long records) {
+    int64_t* cents = (int64_t*)malloc(records * sizeof(int64_t));
+    float* costs = (float*)malloc(records * sizeof(float));
+    if (cents == NULL || costs == NULL) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    uint64_t state = 88172645463325252ULL;
+    for (long i = 0; i < records; i++) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        cents[i] = 500 + (int64_t)(state % 250000); // 5.00 to 2504.99
+        costs[i] = cents[i] / 100.0f;
+    }
+
+    double start = benchNow();
+    float floatTotal = 0;
+    for (long i = 0; i < records; i++) floatTotal += costs[i];
+    double floatSeconds = benchNow() - start;
+
+    start = benchNow();
+    int64_t scalarTotal = 0;
+    for (long i = 0; i < records; i++) scalarTotal += ((volatile int64_t*)cents)[i];
+    double scalarSeconds = benchNow() - start;
+
+    start = benchNow();
+    int64_t total = sumCosts(cents, records);
+    double vectorSeconds = benchNow() - start;
+
+    int64_t rangeTotal;
+    start = benchNow();
+    size_t inRange = sumCostsInRange(cents, records, 50000, 100000, &rangeTotal);
+    double rangeSeconds = benchNow() - start;
+
+    char exact[24], rangeStr[24];
+    printf("%ld costs\n", records);
+    printf("Exact total:        %s\n", formatCost(total, exact));
+    printf("Float total:        %.2f (off by %.2f)\n", floatTotal, floatTotal - total / 100.0);
+    printf("Float sum:          %.0f M records/s\n", records / floatSeconds / 1e6);
+    printf("Scalar cents sum:   %.0f M records/s%s\n", records / scalarSeconds / 1e6,
+           scalarTotal == total ? "" : " (MISMATCH)");
+    printf("Vector cents sum:   %.0f M records/s\n", records / vectorSeconds / 1e6);
+    printf("Range 500.00-1000.00: %zu records, total %s, %.0f M records/s\n", inRange,
+           formatCost(rangeTotal, rangeStr), records / rangeSeconds / 1e6);
+    free(cents);
+    free(costs);
+}
+
+static int benchCompareCostDesc(const void* a, const void* b) {
+    int64_t x = *(const int64_t*)a, y = *(const int64_t*)b;
+    return (x < y) - (x > y);
+}
+
+static void benchCountVisit(ServiceRecord* record, void* context) {
+    (void)record;
+    (*(size_t*)context)++;
+}
+
+// Top-K, k-th largest and cost-range queries: order-statistic index versus scan and sort
+static void benchCostIndex(long records) {
+    ServiceRecord* head = benchBuildList(records);
+    int queries = 1000;
+    size_t visited = 0;
+
+    double start = benchNow();
+    for (int q = 0; q < queries; q++) orderTreeLargest(&costIndex, 100, benchCountVisit, &visited);
+    double topSeconds = benchNow() - start;
+
+    start = benchNow();
+    int64_t checksum = 0;
+    for (int q = 0; q < queries; q++) checksum += kthMostExpensive((size_t)(q * 37 % records) + 1)->costCents;
+    double kthSeconds = benchNow() - start;
+
+    start = benchNow();
+    for (int q = 0; q < queries; q++) {
+        int64_t lo = 10000 + q * 80;
+        orderTreeRange(&costIndex, lo, lo + 50, benchCountVisit, &visited);
+    }
+    double rangeSeconds = benchNow() - start;
+
+    // Baseline: copy every cost out of the list and sort, as a report had to before
+    int scans = 5;
+    int64_t* costs = (int64_t*)malloc(records * sizeof(int64_t));
+    start = benchNow();
+    for (int q = 0; q < scans; q++) {
+        long n = 0;
+        for (ServiceRecord* r = head; r != NULL; r = r->next) costs[n++] = r->costCents;
+        qsort(costs, n, sizeof(int64_t), benchCompareCostDesc);
+        checksum += costs[99 % n];
+    }
+    double scanSeconds = (benchNow() - start) / scans;
+
+    printf("%ld records (checksum %lld)\n", records, (long long)checksum);
+    printf("Top-100 via index:     %8.2f us/query\n", topSeconds / queries * 1e6);
+    printf("k-th largest via index:%8.2f us/query\n", kthSeconds / queries * 1e6);
+    printf("Cost range via index:  %8.2f us/query\n", rangeSeconds / queries * 1e6);
+    printf("Top-100 via scan+sort: %8.2f us/query\n", scanSeconds * 1e6);
+    free(costs);
+    freeList(&head);
+}
+
+// Tombstone cost, then space amplification before and after compaction
+static void benchCompaction(long records) {
+    char filename[64], dictPath[80];
+    snprintf(filename, sizeof(filename), "/tmp/service_bench_compaction.%d.dat", (int)getpid());
+    snprintf(dictPath, sizeof(dictPath), "%s.dict", filename);
+    ServiceRecord* head = benchBuildList(records);
+    saveToFile(head, filename);
+
+    // Delete every third record, plus a dense run that empties whole segments
+    long deleted = 0, index = 0;
+    ServiceRecord* current = head;
+    double start = benchNow();
+    while (current != NULL) {
+        ServiceRecord* next = current->next;
+        if (index % 3 == 0 || (index > records / 2 && index < records / 2 + records / 10)) {
+            removeRecord(&head, current);
+            deleted++;
+        }
+        current = next;
+        index++;
+    }
+    double deleteSeconds = benchNow() - start;
+    printf("%ld records, %ld deleted at %.2f us each (tombstone included)\n", records, deleted,
+           deleteSeconds / deleted * 1e6);
+    printf("\nBefore compaction:\n");
+    printStoreStats();
+
+    start = benchNow();
+    size_t segments = compactRecordStore(SIZE_MAX);
+    double compactSeconds = benchNow() - start;
+    printf("\nAfter compacting %zu segments in %.3f s:\n", segments, compactSeconds);
+    printStoreStats();
+
+    // Reloading must give back exactly the surviving records
+    size_t live = columns.count;
+    int64_t total = sumCosts(columns.cents, columns.count);
+    freeList(&head);
+    loadFromFile(&head, filename);
+    int reloaded = columns.count == live && sumCosts(columns.cents, columns.count) == total;
+    printf("Reload check: %zu records, %s\n", columns.count, reloaded ? "ok" : "MISMATCH");
+
+    freeList(&head);
+    unlink(filename);
+    unlink(dictPath);
+}
+
+// Cost of recording updates and of answering as-of queries from the chains
+static void benchHistory(long records) {
+    const int updates = 8;
+    ServiceRecord* head = benchBuildList(records);
+    uint64_t typeIds[BENCH_SERVICE_TYPES];
+    for (int t = 0; t < BENCH_SERVICE_TYPES; t++) typeIds[t] = internString(&serviceTypes, benchServiceTypes[t]);
+
+    // Update i happens at time i * 1000; each changes the cost, every other one the type
+    double start = benchNow();
+    for (int u = 1; u <= updates; u++) {
+        for (ServiceRecord* r = head; r != NULL; r = r->next) {
+            ServiceRecord before = *r;
+            setRecordCost(r, r->costCents + 500);
+            if (u % 2 == 0) r->serviceTypeId = (uint16_t)typeIds[u % BENCH_SERVICE_TYPES];
+            recordVersionPush(r, &before, (int64_t)u * 1000);
+        }
+    }
+    double pushSeconds = benchNow() - start;
+
+    long queries = records, mismatches = 0;
+    char vehicleNumber[20];
+    ServiceRecord state;
+    start = benchNow();
+    for (long i = 0; i < queries; i++) {
+        benchVehicleNumber((uint64_t)(i * 7919 % records), vehicleNumber);
+        ServiceRecord* record = findVehicle(vehicleNumber);
+        int64_t when = (int64_t)(i % (updates + 1)) * 1000;
+        recordAsOf(record, when, &state);
+        int applied = (int)(when / 1000);
+        if (state.costCents != record->costCents - (updates - applied) * 500) mismatches++;
+    }
+    double querySeconds = benchNow() - start;
+
+    printf("%ld records, %d updates each\n", records, updates);
+    printf("Version push: %.0f ns each\n", pushSeconds / (records * updates) * 1e9);
+    printf("History memory: %.1f bytes per version (full record: %zu bytes)\n",
+           (double)recordHistory.bytes / recordHistory.versions, sizeof(ServiceRecord));
+    printf("As-of query: %.0f ns each, %ld mismatches\n", querySeconds / queries * 1e9, mismatches);
+    freeList(&head);
+}
+
+typedef struct BenchSaver {
+    ServiceRecord* head;
+    const char* filename;
+    int saves;
+} BenchSaver;
+
+static void* benchSaveThread(void* arg) {
+    BenchSaver* saver = (BenchSaver*)arg;
+    for (int i = 0; i < saver->saves; i++) saveToFile(saver->head, saver->filename);
+    return NULL;
+}
+
+// Atomic save throughput, group commit under concurrent saves, checksum
+// verification speed at load and detection of a corrupted segment
+static void benchSave(long records) {
+    char filename[64], path[80];
+    snprintf(filename, sizeof(filename), "/tmp/service_bench_save.%d.dat", (int)getpid());
+    ServiceRecord* head = benchBuildList(records);
+
+    double start = benchNow();
+    saveToFile(head, filename);
+    double saveSeconds = benchNow() - start;
+    struct stat st;
+    stat(filename, &st);
+    printf("%ld records, %.1f MB file, saved in %.3f s (%.1f MB/s including fsync)\n", records,
+           st.st_size / 1e6, saveSeconds, st.st_size / saveSeconds / 1e6);
+
+    // Eight threads saving at once share writes instead of queueing one each
+    enum { SAVERS = 8, SAVES_EACH = 4 };
+    pthread_t threads[SAVERS];
+    BenchSaver saver = { head, filename, SAVES_EACH };
+    uint64_t commitsBefore = saveQueue.commits;
+    start = benchNow();
+    for (int t = 0; t < SAVERS; t++) pthread_create(&threads[t], NULL, benchSaveThread, &saver);
+    for (int t = 0; t < SAVERS; t++) pthread_join(threads[t], NULL);
+    printf("Group commit: %d concurrent saves written as %llu files in %.3f s\n", SAVERS * SAVES_EACH,
+           (unsigned long long)(saveQueue.commits - commitsBefore), benchNow() - start);
+
+    // Raw read speed of the same (cached) file, for comparison with verified load
+    int fd = open(filename, O_RDONLY);
+    char* raw = (char*)malloc(st.st_size);
+    start = benchNow();
+    ssize_t got = pread(fd, raw, st.st_size, 0);
+    double readSeconds = benchNow() - start;
+    close(fd);
+    free(raw);
+    freeList(&head);
+    loadFromFile(&head, filename);
+    printf("Load read+verify: %.1f MB/s on %ld CPUs (plain read: %.1f MB/s), %zu records\n",
+           recordStores[0].verifiedBytes / recordStores[0].verifySeconds / 1e6, sysconf(_SC_NPROCESSORS_ONLN),
+           got / readSeconds / 1e6, columns.count);
+
+    // Flip one cost byte in the fourth segment
+    freeList(&head);
+    fd = open(filename, O_RDWR);
+    off_t offset = slotOffset(3 * SEGMENT_SLOTS + 17) + offsetof(DiskRecord, costCents);
+    uint8_t byte;
+    pread(fd, &byte, 1, offset);
+    byte ^= 0x40;
+    pwrite(fd, &byte, 1, offset);
+    close(fd);
+    loadFromFile(&head, filename);
+    printf("After corrupting one byte: %llu corrupt segment(s), %zu records loaded\n",
+           (unsigned long long)recordStores[0].corruptSegments, columns.count);
+
+    freeList(&head);
+    unlink(filename);
+    snprintf(path, sizeof(path), "%s.dict", filename);
+    unlink(path);
+    snprintf(path, sizeof(path), "%s.hist", filename);
+    unlink(path);
+    snprintf(path, sizeof(path), "%s.idx", filename);
+    unlink(path);
+}
+
+// ---- Operation harness: synthetic workload with skewed popularity ----
+
+// Share of each benchServiceTypes entry in the workload, and its cost range in cents
+static const int benchTypeWeights[BENCH_SERVICE_TYPES] = { 30, 14, 12, 8, 8, 6, 18, 4 };
+static const int64_t benchTypeCosts[BENCH_SERVICE_TYPES][2] = {
+    { 2500, 6000 }, { 15000, 60000 }, { 3000, 8000 }, { 8000, 25000 },
+    { 4000, 10000 }, { 6000, 20000 }, { 5000, 15000 }, { 30000, 120000 }
+};
+
+#define BENCH_ZIPF_EXPONENT 1.1     // vehicle popularity skew
+#define BENCH_OP_SECONDS 2.0        // time budget per operation and size
+#define BENCH_OP_MAX 200000         // sample cap per operation and size
+
+// xorshift64*
+static uint64_t benchRand(uint64_t* state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 2685821657736338717ULL;
+}
+
+static double benchUniform(uint64_t* state) {
+    return (benchRand(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Rank in [0, n) with P(rank) roughly proportional to 1 / (rank + 1)^s,
+// by inverting the continuous power-law CDF
+static uint64_t benchZipf(uint64_t* state, uint64_t n, double s) {
+    double u = benchUniform(state);
+    double x = pow((pow((double)n + 1, 1 - s) - 1) * u + 1, 1 / (1 - s));
+    uint64_t rank = (uint64_t)x - 1;
+    return rank < n ? rank : n - 1;
+}
+
+// Spread popularity ranks over the vehicles so popular ones are not all
+// at one end of the list (the stride is coprime with n)
+static uint64_t benchRankToVehicle(uint64_t rank, uint64_t n) {
+    uint64_t stride = 2654435761ULL % n, a = stride, b = n;
+    while (b != 0) {
+        uint64_t t = a % b;
+        a = b;
+        b = t;
+    }
+    if (a != 1 || stride == 0) stride = 1;
+    return (uint64_t)((unsigned __int128)rank * stride % n);
+}
+
+// One synthetic service: weighted service type, a cost in its range, a date
+// in 2022-2025 and an owner drawn with fleet-like skew. With checkDuplicate
+// it goes through insertRecord like addRecord does; the initial build skips
+// that, as the synthetic plates are unique anyway.
+static ServiceRecord* benchInsertVehicle(ServiceRecord** head, uint64_t vehicle, uint64_t records,
+                                         uint64_t* rng, int checkDuplicate) {
+    char vehicleNumber[20], ownerName[50], date[11];
+    int pick = (int)(benchRand(rng) % 100), type = 0;
+    while (pick >= benchTypeWeights[type]) pick -= benchTypeWeights[type++];
+    int64_t low = benchTypeCosts[type][0], high = benchTypeCosts[type][1];
+    int64_t cents = low + (int64_t)(benchRand(rng) % (uint64_t)(high - low + 1));
+    benchVehicleNumber(vehicle, vehicleNumber);
+    snprintf(ownerName, sizeof(ownerName), "Customer %llu",
+             (unsigned long long)benchZipf(rng, records / 2 + 1, 1.2));
+    snprintf(date, sizeof(date), "%02d-%02d-%d", (int)(benchRand(rng) % 28) + 1,
+             (int)(benchRand(rng) % 12) + 1, 2022 + (int)(benchRand(rng) % 4));
+    if (checkDuplicate) {
+        return insertRecord(head, vehicleNumber, ownerName, (char*)benchServiceTypes[type], date, cents);
+    }
+    ServiceRecord* record = createRecord(vehicleNumber, ownerName, (char*)benchServiceTypes[type], date, cents);
+    linkRecord(head, record);
+    return record;
+}
+
+static int benchCompareDouble(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile of sorted samples
+static double benchPercentile(const double* sorted, size_t count, double p) {
+    size_t rank = (size_t)ceil(p * count);
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+// Emit one result line; samples are per-operation seconds
+static void benchReportOp(const char* op, long records, double* samples, size_t count, double seconds) {
+    if (count == 0) return;
+    qsort(samples, count, sizeof(double), benchCompareDouble);
+    printf("{\"suite\": \"ops\", \"op\": \"%s\", \"records\": %ld, \"ops\": %zu, "
+           "\"ops_per_sec\": %.3f, \"mean_us\": %.3f, \"p50_us\": %.3f, \"p90_us\": %.3f, "
+           "\"p99_us\": %.3f, \"p999_us\": %.3f, \"max_us\": %.3f}\n",
+           op, records, count, count / seconds, seconds / count * 1e6,
+           benchPercentile(samples, count, 0.50) * 1e6, benchPercentile(samples, count, 0.90) * 1e6,
+           benchPercentile(samples, count, 0.99) * 1e6, benchPercentile(samples, count, 0.999) * 1e6,
+           samples[count - 1] * 1e6);
+    fflush(stdout);
+}
+
+// Throughput and latency of each store operation on a store of `records` vehicles
+static void benchOpsAtSize(long records, double* samples) {
+    char filename[64], path[80], vehicleNumber[20];
+    snprintf(filename, sizeof(filename), "/tmp/service_bench_ops.%d.dat", (int)getpid());
+    uint64_t rng = 0x9E3779B97F4A7C15ULL ^ (uint64_t)records;
+    uint64_t n = (uint64_t)records;
+    ServiceRecord* head = NULL;
+
+    double start = benchNow();
+    for (uint64_t v = 0; v < n; v++) benchInsertVehicle(&head, v, n, &rng, 0);
+    printf("{\"suite\": \"ops\", \"op\": \"build\", \"records\": %ld, \"seconds\": %.3f, "
+           "\"cpus\": %ld}\n", records, benchNow() - start, sysconf(_SC_NPROCESSORS_ONLN));
+
+    // add: new vehicles, duplicate check included; the store grows by at most 10%
+    size_t count = 0, maxAdds = n / 10 > 1000 ? n / 10 : 1000;
+    double opStart, total = 0;
+    if (maxAdds > BENCH_OP_MAX) maxAdds = BENCH_OP_MAX;
+    for (uint64_t v = n; count < maxAdds && total < BENCH_OP_SECONDS; v++) {
+        opStart = benchNow();
+        benchInsertVehicle(&head, v, n, &rng, 1);
+        samples[count] = benchNow() - opStart;
+        total += samples[count++];
+    }
+    uint64_t added = count;
+    benchReportOp("add", records, samples, count, total);
+
+    // search: popular vehicles most of the time, 5% misses
+    count = 0;
+    total = 0;
+    while (count < BENCH_OP_MAX && total < BENCH_OP_SECONDS) {
+        uint64_t vehicle = benchRand(&rng) % 20 == 0 ? n + added + count
+                                                     : benchRankToVehicle(benchZipf(&rng, n, BENCH_ZIPF_EXPONENT), n);
+        benchVehicleNumber(vehicle, vehicleNumber);
+        opStart = benchNow();
+        searchRecord(head, vehicleNumber);
+        samples[count] = benchNow() - opStart;
+        total += samples[count++];
+    }
+    benchReportOp("search", records, samples, count, total);
+
+    // update: find a popular vehicle and change its cost
+    count = 0;
+    total = 0;
+    while (count < BENCH_OP_MAX && total < BENCH_OP_SECONDS) {
+        benchVehicleNumber(benchRankToVehicle(benchZipf(&rng, n, BENCH_ZIPF_EXPONENT), n), vehicleNumber);
+        opStart = benchNow();
+        ServiceRecord* record = searchRecord(head, vehicleNumber);
+        if (record != NULL) modifyRecord(record, NULL, NULL, NULL, record->costCents + 100);
+        samples[count] = benchNow() - opStart;
+        total += samples[count++];
+    }
+    benchReportOp("update", records, samples, count, total);
+
+    // delete: distinct vehicles spread over the list
+    count = 0;
+    total = 0;
+    uint64_t offset = benchRand(&rng) % n;
+    while (count < BENCH_OP_MAX && count < n / 2 && total < BENCH_OP_SECONDS) {
+        benchVehicleNumber(benchRankToVehicle((offset + count) % n, n), vehicleNumber);
+        opStart = benchNow();
+        removeVehicle(&head, vehicleNumber);
+        samples[count] = benchNow() - opStart;
+        total += samples[count++];
+    }
+    benchReportOp("delete", records, samples, count, total);
+
+    // save and load: whole-store operations, fewer repetitions on big stores
+    int reps = records >= 5000000 ? 1 : 3;
+    total = 0;
+    for (int r = 0; r < reps; r++) {
+        opStart = benchNow();
+        saveToFile(head, filename);
+        samples[r] = benchNow() - opStart;
+        total += samples[r];
+    }
+    benchReportOp("save", records, samples, reps, total);
+    total = 0;
+    for (int r = 0; r < reps; r++) {
+        freeList(&head);
+        opStart = benchNow();
+        loadFromFile(&head, filename);
+        samples[r] = benchNow() - opStart;
+        total += samples[r];
+    }
+    benchReportOp("load", records, samples, reps, total);
+
+    freeList(&head);
+    unlink(filename);
+    snprintf(path, sizeof(path), "%s.dict", filename);
+    unlink(path);
+    snprintf(path, sizeof(path), "%s.hist", filename);
+    unlink(path);
+    snprintf(path, sizeof(path), "%s.idx", filename);
+    unlink(path);
+}
+
+static void benchOps(long records) {
+    static const long sizes[] = { 10000, 1000000, 10000000 };
+    double* samples = (double*)malloc(BENCH_OP_MAX * sizeof(double));
+    if (samples == NULL) return;
+    if (records > 0) {
+        benchOpsAtSize(records, samples);
+    } else {
+        for (int i = 0; i < 3; i++) benchOpsAtSize(sizes[i], samples);
+    }
+    free(samples);
+}
+
+// Compiled filter expressions: compile cost, the plan chosen and scan
+// throughput, against a hand-written predicate for the first query
+static void benchQuery(long records) {
+    static const char* queries[] = {
+        "type = \"Brake Service\" AND cost > 500 AND date IN 2025",
+        "cost >= 100 AND cost < 120 AND type != \"Oil Change\"",
+        "owner = \"Customer 1\"",
+        "owner = \"Customer 1\" OR owner = \"Customer 2\"",
+        "vehicle = KA06AA0042",
+        "date >= 01-06-2024 AND date <= 07-06-2024 AND NOT type = \"Oil Change\"",
+        "(type = \"Tyre Rotation\" OR type = \"Battery Replacement\") AND date IN 2023",
+    };
+    uint64_t rng = 0x9E3779B97F4A7C15ULL ^ (uint64_t)records;
+    ServiceRecord* head = NULL;
+    for (uint64_t v = 0; v < (uint64_t)records; v++) benchInsertVehicle(&head, v, records, &rng, 0);
+    printf("%ld records\n", records);
+
+    for (size_t q = 0; q < sizeof(queries) / sizeof(queries[0]); q++) {
+        int compiles = 10000;
+        double start = benchNow();
+        for (int i = 0; i < compiles; i++) freeQuery(compileQuery(queries[q]));
+        double compileSeconds = (benchNow() - start) / compiles;
+
+        Query* query = compileQuery(queries[q]);
+        QueryStats stats;
+        size_t scanned = 0, runs = 0;
+        double seconds = 0;
+        while (runs < 3 || (seconds < 0.5 && runs < 100000)) {
+            runQuery(query, NULL, NULL, &stats);
+            scanned += stats.scanned;
+            seconds += stats.seconds;
+            runs++;
+        }
+        printf("%s\n  plan: %s; %zu matches; compile %.2f us; %.3f ms/query; %.1f M records/s\n",
+               queries[q], stats.plan, stats.matches, compileSeconds * 1e6, seconds / runs * 1e3,
+               seconds > 0 ? scanned / seconds / 1e6 : 0);
+        freeQuery(query);
+    }
+
+    // The first query written out by hand, as the bound on what compiling can reach
+    uint32_t brake = 0;
+    findString(&serviceTypes, "Brake Service", &brake);
+    size_t matches = 0;
+    int scans = 5;
+    double start = benchNow();
+    for (int i = 0; i < scans; i++) {
+        for (ServiceRecord* r = head; r != NULL; r = r->next) {
+            int64_t key = dateKey(r->date);
+            matches += r->serviceTypeId == brake && r->costCents > 50000 && key >= 20250101 && key <= 20251231;
+        }
+    }
+    double handSeconds = benchNow() - start;
+    printf("Hand-written first query: %zu matches; %.1f M records/s\n", matches / scans,
+           (double)records * scans / handSeconds / 1e6);
+    freeList(&head);
+}
+
+// Per-type revenue for one year and a filter query, walking the list versus
+// streaming the column mirror, then a check that the mirror still matches
+// the records after a round of updates and deletes
+static void benchColumns(long records) {
+    uint64_t rng = 0x9E3779B97F4A7C15ULL ^ (uint64_t)records;
+    ServiceRecord* head = NULL;
+    for (uint64_t v = 0; v < (uint64_t)records; v++) benchInsertVehicle(&head, v, records, &rng, 0);
+    int64_t totals[BENCH_SERVICE_TYPES + 1] = { 0 };
+    int scans = 5;
+
+    double start = benchNow();
+    for (int i = 0; i < scans; i++) {
+        for (ServiceRecord* r = head; r != NULL; r = r->next) {
+            int64_t key = dateKey(r->date);
+            if (key >= 20250101 && key <= 20251231) totals[r->serviceTypeId] += r->costCents;
+        }
+    }
+    double listSeconds = (benchNow() - start) / scans;
+    int64_t listTotal = 0;
+    for (int t = 0; t < BENCH_SERVICE_TYPES; t++) listTotal += totals[t], totals[t] = 0;
+
+    start = benchNow();
+    for (int i = 0; i < scans; i++) {
+        for (size_t row = 0; row < columns.count; row++) {
+            uint32_t key = columns.dates[row];
+            if (key >= 20250101 && key <= 20251231) totals[columns.typeIds[row]] += columns.cents[row];
+        }
+    }
+    double columnSeconds = (benchNow() - start) / scans;
+    int64_t columnTotal = 0;
+    for (int t = 0; t < BENCH_SERVICE_TYPES; t++) columnTotal += totals[t];
+
+    printf("%ld records\n", records);
+    printf("Revenue by type, 2025, list walk:   %8.2f ms (%.1f M records/s)\n", listSeconds * 1e3,
+           records / listSeconds / 1e6);
+    printf("Revenue by type, 2025, columns:     %8.2f ms (%.1f M records/s, %.1f GB/s) %s\n",
+           columnSeconds * 1e3, records / columnSeconds / 1e6,
+           records * (double)(sizeof(int64_t) + sizeof(uint32_t) + sizeof(uint16_t)) / columnSeconds / 1e9,
+           listTotal == columnTotal ? "same total" : "TOTAL MISMATCH");
+
+    // With the mirror off runQuery reads the records themselves; nothing changes meanwhile
+    Query* query = compileQuery("type = \"Brake Service\" AND cost > 500 AND date IN 2025");
+    QueryStats stats;
+    double seconds[2] = { 0, 0 };
+    size_t matches[2] = { 0, 0 };
+    for (int mirror = 0; mirror < 2; mirror++) {
+        columns.mirror = mirror;
+        for (int i = 0; i < scans; i++) {
+            runQuery(query, NULL, NULL, &stats);
+            seconds[mirror] += stats.seconds / scans;
+        }
+        matches[mirror] = stats.matches;
+    }
+    freeQuery(query);
+    printf("Query record scan:                  %8.2f ms (%.1f M records/s)\n", seconds[0] * 1e3,
+           records / seconds[0] / 1e6);
+    printf("Query column scan:                  %8.2f ms (%.1f M records/s) %s\n", seconds[1] * 1e3,
+           records / seconds[1] / 1e6, matches[0] == matches[1] ? "same matches" : "MATCH MISMATCH");
+
+    // Incremental maintenance: update a tenth of the records and delete a few
+    // thousand (each delete walks the list to unlink)
+    char vehicleNumber[20], ownerName[32], date[11];
+    size_t changes = (size_t)records / 10, deletes = changes < 2000 ? changes : 2000;
+    start = benchNow();
+    for (size_t i = 0; i < changes; i++) {
+        uint64_t v = benchRand(&rng) % (uint64_t)records;
+        benchVehicleNumber(v, vehicleNumber);
+        ServiceRecord* record = findVehicle(vehicleNumber);
+        if (record == NULL) continue;
+        snprintf(ownerName, sizeof(ownerName), "Customer %llu", (unsigned long long)(benchRand(&rng) % 1000));
+        snprintf(date, sizeof(date), "%02d-%02d-2024", (int)(benchRand(&rng) % 28) + 1,
+                 (int)(benchRand(&rng) % 12) + 1);
+        modifyRecord(record, ownerName, benchServiceTypes[benchRand(&rng) % BENCH_SERVICE_TYPES], date,
+                     (int64_t)(benchRand(&rng) % 100000));
+    }
+    for (size_t i = 0; i < deletes; i++) {
+        benchVehicleNumber(benchRand(&rng) % (uint64_t)records, vehicleNumber);
+        removeVehicle(&head, vehicleNumber);
+    }
+    double changeSeconds = benchNow() - start;
+    size_t rows = 0, bad = 0;
+    for (ServiceRecord* r = head; r != NULL; r = r->next, rows++) {
+        size_t row = r->columnRow;
+        bad += row >= columns.count || columns.records[row] != r || columns.cents[row] != r->costCents ||
+               columns.dates[row] != (uint32_t)dateKey(r->date) || columns.typeIds[row] != r->serviceTypeId ||
+               columns.ownerIds[row] != r->ownerId ||
+               columns.vehicleHashes[row] != (uint32_t)plateKeyHash(r->vehicleNumber);
+    }
+    printf("%zu updates + %zu deletes in %.2f s; mirror check: %zu rows, %s\n", changes, deletes,
+           changeSeconds, rows, bad == 0 && rows == columns.count ? "ok" : "MISMATCH");
+    freeList(&head);
+}
+
+// Parallel scans from 1 to 32 threads: a filter query, the per-type
+// summary, a cost-range total and a CSV export, with speedup over 1 thread
+static void benchScan(long records) {
+    static const int threadCounts[] = { 1, 2, 4, 8, 16, 32 };
+    uint64_t rng = 0x9E3779B97F4A7C15ULL ^ (uint64_t)records;
+    ServiceRecord* head = NULL;
+    for (uint64_t v = 0; v < (uint64_t)records; v++) benchInsertVehicle(&head, v, records, &rng, 0);
+    Query* query = compileQuery("(type = \"Brake Service\" OR type = \"Clutch Repair\") AND cost > 500");
+    size_t* counts = (size_t*)calloc(serviceTypes.count + 1, sizeof(size_t));
+    int64_t* totals = (int64_t*)calloc(serviceTypes.count + 1, sizeof(int64_t));
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/service_bench_export.%d.csv", (int)getpid());
+    double base[4] = { 0, 0, 0, 0 };
+    uint64_t baseChecksum = 0;
+    int scans = 5;
+
+    printf("%ld records, %ld CPUs; ms per scan (speedup over 1 thread)\n", records,
+           sysconf(_SC_NPROCESSORS_ONLN));
+    printf("%8s %16s %16s %16s %16s\n", "threads", "query", "type summary", "cost range", "export");
+    for (size_t i = 0; i < sizeof(threadCounts) / sizeof(threadCounts[0]); i++) {
+        setScanThreads(threadCounts[i]);
+        double seconds[4] = { 0, 0, 0, 0 };
+        QueryStats stats;
+        int64_t total;
+        runQuery(query, NULL, NULL, &stats); // starts the pool
+        for (int r = 0; r < scans; r++) {
+            double start = benchNow();
+            runQuery(query, NULL, NULL, &stats);
+            seconds[0] += benchNow() - start;
+            start = benchNow();
+            summarizeServiceTypes(20250101, 20251231, counts, totals);
+            seconds[1] += benchNow() - start;
+            start = benchNow();
+            totalCostsInRange(20000, 60000, &total);
+            seconds[2] += benchNow() - start;
+        }
+        unlink(path); // replacing the previous export makes the fsync slower
+        double start = benchNow();
+        size_t exported = exportRecords(path);
+        seconds[3] = (benchNow() - start) * scans;
+
+        // Every thread count must produce the same results; unsigned, so the
+        // hash may wrap
+        uint64_t checksum = (uint64_t)stats.matches * 31 + (uint64_t)total + exported;
+        for (uint32_t t = 0; t < serviceTypes.count; t++) {
+            checksum = checksum * 31 + (uint64_t)totals[t] + counts[t];
+        }
+        memset(counts, 0, (serviceTypes.count + 1) * sizeof(size_t));
+        memset(totals, 0, (serviceTypes.count + 1) * sizeof(int64_t));
+        if (i == 0) baseChecksum = checksum;
+        printf("%8d", threadCounts[i]);
+        for (int k = 0; k < 4; k++) {
+            if (i == 0) base[k] = seconds[k];
+            printf(" %9.2f (%4.1fx)", seconds[k] / scans * 1e3, base[k] / seconds[k]);
+        }
+        printf("%s\n", checksum == baseChecksum ? "" : "  RESULT MISMATCH");
+    }
+    unlink(path);
+    stopScanPool();
+    setScanThreads(0);
+    freeQuery(query);
+    free(counts);
+    free(totals);
+    freeList(&head);
+}
+
+static void benchCountDue(ServiceRecord* record, void* context) {
+    (void)record;
+    (*(size_t*)context)++;
+}
+
+// "Due this week" from the due-day index versus a scan computing every
+// vehicle's due day, and the cost of keeping the index current on updates
+static void benchReminders(long records) {
+    uint64_t rng = 0x9E3779B97F4A7C15ULL ^ (uint64_t)records;
+    ServiceRecord* head = NULL;
+    for (uint64_t v = 0; v < (uint64_t)records; v++) benchInsertVehicle(&head, v, records, &rng, 0);
+    int64_t today = dayNumber(20250601);
+    int queries = 1000;
+
+    size_t scanDue = 0, scanOverdue = 0;
+    double start = benchNow();
+    for (ServiceRecord* r = head; r != NULL; r = r->next) {
+        int64_t due = dayNumber(dateKey(r->date)) + serviceIntervalDays(r->serviceTypeId);
+        scanOverdue += due < today;
+        scanDue += due >= today && due <= today + 7;
+    }
+    double scanSeconds = benchNow() - start;
+
+    size_t indexDue = 0, indexOverdue = 0;
+    start = benchNow();
+    for (int q = 0; q < queries; q++) {
+        indexDue = 0;
+        indexOverdue = countOverdue(today);
+        visitDueRecords(today, today + 7, benchCountDue, &indexDue);
+    }
+    double indexSeconds = (benchNow() - start) / queries;
+
+    start = benchNow();
+    for (int q = 0; q < queries; q++) nextDueRecord();
+    double nextSeconds = (benchNow() - start) / queries;
+
+    // Each update moves the vehicle in the due-day index
+    char vehicleNumber[20], date[11];
+    int updates = 100000;
+    start = benchNow();
+    for (int i = 0; i < updates; i++) {
+        benchVehicleNumber(benchRand(&rng) % (uint64_t)records, vehicleNumber);
+        snprintf(date, sizeof(date), "%02d-%02d-2025", (int)(benchRand(&rng) % 28) + 1,
+                 (int)(benchRand(&rng) % 12) + 1);
+        modifyRecord(findVehicle(vehicleNumber), NULL, NULL, date, COST_UNCHANGED);
+    }
+    double updateSeconds = benchNow() - start;
+
+    printf("%ld vehicles, today 01-06-2025: %zu overdue, %zu due within 7 days\n", records, indexOverdue,
+           indexDue);
+    printf("Full scan:             %10.2f ms%s\n", scanSeconds * 1e3,
+           scanDue == indexDue && scanOverdue == indexOverdue ? "" : " (COUNT MISMATCH)");
+    printf("Index (week + overdue):%10.2f ms (%.0fx)\n", indexSeconds * 1e3, scanSeconds / indexSeconds);
+    printf("Next due vehicle:      %10.2f us\n", nextSeconds * 1e6);
+    printf("Date update, reindexed:%10.2f us\n", updateSeconds / updates * 1e6);
+    freeList(&head);
+}
+
+// Fill a new shared segment with `records` synthetic vehicles
+static SharedStore* benchSharedStore(const char* name, long records, double* putSeconds) {
+    char vehicleNumber[20], date[11];
+    shm_unlink(name);
+    SharedStore* store = sharedStoreOpen(name, (uint64_t)records, NULL);
+    if (store == NULL) {
+        printf("Cannot create shared store %s\n", name);
+        exit(1);
+    }
+    double start = benchNow();
+    for (long i = 0; i < records; i++) {
+        benchVehicleNumber((uint64_t)i, vehicleNumber);
+        snprintf(date, sizeof(date), "%02ld-%02ld-2025", i % 28 + 1, i % 12 + 1);
+        sharedStorePut(store, vehicleNumber, "Owner 0", benchServiceTypes[i % BENCH_SERVICE_TYPES], date, 0);
+    }
+    if (putSeconds != NULL) *putSeconds = benchNow() - start;
+    return store;
+}
+
+// Average cost of mapping and checking an existing segment
+static double benchSharedAttach(const char* name) {
+    int attaches = 1000;
+    double start = benchNow();
+    for (int i = 0; i < attaches; i++) sharedStoreClose(sharedStoreOpen(name, 1, NULL));
+    return (benchNow() - start) / attaches;
+}
+
+// Attach time for a small and a full segment, lock-free reads, locked
+// writes, readers racing a writer in other processes, and recovery from
+// a writer that died holding the lock
+static void benchShared(long records) {
+    char smallName[64], name[64], vehicleNumber[20], owner[50];
+    snprintf(smallName, sizeof(smallName), "/service_bench_small.%d", (int)getpid());
+    snprintf(name, sizeof(name), "/service_bench_shared.%d", (int)getpid());
+    sharedStoreClose(benchSharedStore(smallName, 1000, NULL));
+    double putSeconds;
+    SharedStore* store = benchSharedStore(name, records, &putSeconds);
+
+    double smallAttach = benchSharedAttach(smallName), fullAttach = benchSharedAttach(name);
+
+    uint64_t rng = 0x9E3779B97F4A7C15ULL;
+    long gets = 1000000, hits = 0;
+    SharedRecord record;
+    double start = benchNow();
+    for (long i = 0; i < gets; i++) {
+        benchVehicleNumber(benchRand(&rng) % (uint64_t)records, vehicleNumber);
+        hits += sharedStoreGet(store, vehicleNumber, &record);
+    }
+    double getSeconds = benchNow() - start;
+
+    // The writer keeps each record's owner name and cost in step, so a
+    // reader seeing them disagree has read a half-written record
+    int readers = 2;
+    double runSeconds = 2.0;
+    long* counters = (long*)mmap(NULL, 4 * sizeof(long), PROT_READ | PROT_WRITE,
+                                 MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    memset(counters, 0, 4 * sizeof(long));
+    for (int child = 0; child <= readers; child++) {
+        if (fork() != 0) continue;
+        SharedStore* attached = sharedStoreOpen(name, 1, NULL);
+        uint64_t state = 0xC2B2AE3D27D4EB4FULL * (uint64_t)(child + 1);
+        long done = 0, torn = 0;
+        double until = benchNow() + runSeconds;
+        while ((done & 1023) != 0 || benchNow() < until) {
+            benchVehicleNumber(benchRand(&state) % (uint64_t)records, vehicleNumber);
+            if (child == readers) {
+                int64_t version = (int64_t)done + 1;
+                snprintf(owner, sizeof(owner), "Owner %lld", (long long)version);
+                sharedStorePut(attached, vehicleNumber, owner, "Oil Change", "01-01-2025", version);
+            } else if (sharedStoreGet(attached, vehicleNumber, &record)) {
+                torn += atoll(record.ownerName + 6) != record.costCents;
+            }
+            done++;
+        }
+        __atomic_fetch_add(&counters[child == readers ? 1 : 0], done, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&counters[2], torn, __ATOMIC_RELAXED);
+        sharedStoreClose(attached);
+        _exit(0);
+    }
+    for (int child = 0; child <= readers; child++) wait(NULL);
+
+    // A process that dies mid-write leaves the robust lock to the next
+    // writer, and readers must not wait on it for good either
+    if (fork() == 0) {
+        sharedStoreLock(sharedStoreOpen(name, 1, NULL));
+        _exit(0);
+    }
+    wait(NULL);
+    benchVehicleNumber(1, vehicleNumber);
+    start = benchNow();
+    int readable = sharedStoreGet(store, vehicleNumber, &record);
+    double readSeconds = benchNow() - start;
+    if (fork() == 0) {
+        sharedStoreLock(sharedStoreOpen(name, 1, NULL));
+        _exit(0);
+    }
+    wait(NULL);
+    benchVehicleNumber(0, vehicleNumber);
+    start = benchNow();
+    int recovered = sharedStorePut(store, vehicleNumber, "Owner -1", "Oil Change", "01-01-2025", -1) &&
+                    sharedStoreGet(store, vehicleNumber, &record) && record.costCents == -1;
+    double recoverSeconds = benchNow() - start;
+
+    printf("Shared store, %ld records in a %.1f MB segment\n", records, store->size / 1048576.0);
+    printf("Put (locked):          %10.2f us\n", putSeconds / records * 1e6);
+    printf("Get (lock-free):       %10.2f us (%ld of %ld found)\n", getSeconds / gets * 1e6, hits, gets);
+    printf("Attach, 1000 records:  %10.2f us\n", smallAttach * 1e6);
+    snprintf(owner, sizeof(owner), "Attach, %ld records:", records);
+    printf("%-23s%10.2f us\n", owner, fullAttach * 1e6);
+    printf("%d reader processes + 1 writer for %.0f s: %.0f reads/s, %.0f writes/s, %ld torn reads\n",
+           readers, runSeconds, counters[0] / runSeconds, counters[1] / runSeconds, counters[2]);
+    printf("Get after a writer died holding the lock: %s (%.2f us)\n", readable ? "ok" : "FAILED",
+           readSeconds * 1e6);
+    printf("Put after a writer died holding the lock: %s (%.2f us)\n", recovered ? "ok" : "FAILED",
+           recoverSeconds * 1e6);
+
+    munmap(counters, 4 * sizeof(long));
+    sharedStoreClose(store);
+    shm_unlink(name);
+    shm_unlink(smallName);
+}
+
+// Plate keys for `count` plates typed the ways the desk and the gate see
+// them, with the vector path against the byte-at-a-time one
+static void benchPlates(long count) {
+    enum { VARIANTS = 4096 };
+    static char plates[VARIANTS][32];
+    char vehicleNumber[20];
+    uint64_t rng = 0x9E3779B97F4A7C15ULL;
+    for (int i = 0; i < VARIANTS; i++) {
+        benchVehicleNumber(benchRand(&rng) % 1000000, vehicleNumber);
+        switch (i % 4) {
+            case 0: // "ab 12 cd 3456"
+                snprintf(plates[i], sizeof(plates[i]), "%c%c %.2s %c%c %s", vehicleNumber[0] | 0x20,
+                         vehicleNumber[1] | 0x20, vehicleNumber + 2, vehicleNumber[4] | 0x20,
+                         vehicleNumber[5] | 0x20, vehicleNumber + 6);
+                break;
+            case 1: // "AB-12-CD-3456"
+                snprintf(plates[i], sizeof(plates[i]), "%.2s-%.2s-%.2s-%s", vehicleNumber, vehicleNumber + 2,
+                         vehicleNumber + 4, vehicleNumber + 6);
+                break;
+            default:
+                snprintf(plates[i], sizeof(plates[i]), "%s", vehicleNumber);
+        }
+    }
+
+    // Also check the edge cases: empty, all separators, too long to keep
+    snprintf(plates[3], sizeof(plates[3]), "%s", "");
+    snprintf(plates[7], sizeof(plates[7]), "%s", " - - . ");
+    snprintf(plates[11], sizeof(plates[11]), "%s", "abcdefghijklmnopqrstuvwxyz01234");
+    snprintf(plates[15], sizeof(plates[15]), "%s", "x1-x2-x3-x4-x5-x6-x7-x8-x9-x0");
+
+    char simdKey[PLATE_KEY_SIZE], scalarKey[PLATE_KEY_SIZE];
+    int mismatches = 0;
+    for (int i = 0; i < VARIANTS; i++) {
+        normalizePlate(plates[i], simdKey);
+        normalizePlateScalar(plates[i], scalarKey);
+        mismatches += memcmp(simdKey, scalarKey, PLATE_KEY_SIZE) != 0;
+    }
+
+    uint64_t scalarCheck = 0, simdCheck = 0;
+    double start = benchNow();
+    for (long i = 0; i < count; i++) {
+        normalizePlateScalar(plates[i & (VARIANTS - 1)], scalarKey);
+        scalarCheck += plateKeyHash(scalarKey);
+    }
+    double scalarSeconds = benchNow() - start;
+
+    start = benchNow();
+    for (long i = 0; i < count; i++) simdCheck += normalizePlate(plates[i & (VARIANTS - 1)], simdKey);
+    double simdSeconds = benchNow() - start;
+
+    printf("Plate keys for %ld plates (e.g. \"%s\", \"%s\")%s\n", count, plates[0], plates[1],
+           mismatches || scalarCheck != simdCheck ? " (KEY MISMATCH)" : "");
+    printf("Byte at a time: %8.2f ns/plate, %7.1f M plates/s\n", scalarSeconds / count * 1e9,
+           count / scalarSeconds / 1e6);
+    printf("SIMD:           %8.2f ns/plate, %7.1f M plates/s (%.1fx)\n", simdSeconds / count * 1e9,
+           count / simdSeconds / 1e6, scalarSeconds / simdSeconds);
+}
+
+// Branch b's record for vehicle v; branches disagree on the vehicles they share
+static void benchMergeDate(int branch, long vehicle, char* date) {
+    snprintf(date, 11, "%02ld-%02ld-2025", (vehicle * 7 + branch * 5) % 28 + 1, (vehicle + branch * 3) % 12 + 1);
+}
+
+// A /proc/self/status field in kB
+static long benchStatusKb(const char* field) {
+    char line[128];
+    long value = 0;
+    size_t length = strlen(field);
+    FILE* file = fopen("/proc/self/status", "r");
+    if (file == NULL) return 0;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        if (strncmp(line, field, length) == 0) value = atol(line + length);
+    }
+    fclose(file);
+    return value;
+}
+
+// Merge four branch files that share a quarter of their vehicles with their
+// neighbours, under shrinking run buffers; each merge runs in its own
+// process so its peak memory can be measured, and the result is checked
+// against the latest-date rule
+static void benchMerge(long records) {
+    enum { BRANCHES = 4 };
+    static const int bufferMb[] = { 256, 16, 1 };
+    char paths[BRANCHES][64], output[64], path[300], vehicleNumber[20], ownerName[50], date[11];
+    char* inputs[BRANCHES];
+    long perBranch = records / BRANCHES, stride = perBranch * 3 / 4;
+    long vehicles = stride * (BRANCHES - 1) + perBranch;
+    snprintf(output, sizeof(output), "/tmp/service_bench_merge.%d.dat", (int)getpid());
+
+    double start = benchNow();
+    for (int b = 0; b < BRANCHES; b++) {
+        snprintf(paths[b], sizeof(paths[b]), "/tmp/service_bench_branch%d.%d.dat", b, (int)getpid());
+        inputs[b] = paths[b];
+        ServiceRecord* head = NULL;
+        for (long v = b * stride; v < b * stride + perBranch; v++) {
+            benchVehicleNumber((uint64_t)v, vehicleNumber);
+            snprintf(ownerName, sizeof(ownerName), "Customer %ld", v / 3);
+            benchMergeDate(b, v, date);
+            linkRecord(&head, createRecord(vehicleNumber, ownerName,
+                                           (char*)benchServiceTypes[v % BENCH_SERVICE_TYPES], date,
+                                           10000 + (v * 7919 + b * 1000) % 90000));
+        }
+        saveToFile(head, paths[b]);
+        freeList(&head);
+    }
+    printf("%d branch files, %ld records, %ld distinct vehicles (built in %.2f s)\n\n", BRANCHES,
+           perBranch * BRANCHES, vehicles, benchNow() - start);
+
+    for (size_t c = 0; c < sizeof(bufferMb) / sizeof(bufferMb[0]); c++) {
+        // Each merge writes a new file; replacing one costs the file system extra flushes
+        snprintf(path, sizeof(path), "%s.dict", output);
+        unlink(output);
+        unlink(path);
+        fflush(stdout);
+        start = benchNow();
+        if (fork() == 0) {
+            // Start the peak-RSS count afresh so only the merge is measured
+            FILE* clear = fopen("/proc/self/clear_refs", "w");
+            if (clear != NULL) {
+                fputs("5", clear);
+                fclose(clear);
+            }
+            long baseKb = benchStatusKb("VmRSS:");
+            int ok = mergeRecordFiles(output, inputs, BRANCHES, MERGE_LATEST, (size_t)bufferMb[c] << 20);
+            printf("Run buffer %3d MB: peak memory +%.1f MB\n", bufferMb[c],
+                   (benchStatusKb("VmHWM:") - baseKb) / 1024.0);
+            fflush(stdout);
+            _exit(ok ? 0 : 1);
+        }
+        int status;
+        wait(&status);
+        double seconds = benchNow() - start;
+        printf("Merge time %.2f s, %.0f records/s%s\n\n", seconds, perBranch * BRANCHES / seconds,
+               status == 0 ? "" : " (FAILED)");
+    }
+
+    // Every vehicle must appear once, with the latest date any branch holds
+    ServiceRecord* head = NULL;
+    loadFromFile(&head, output);
+    long wrong = 0;
+    for (long v = 0; v < vehicles; v++) {
+        int64_t expected = 0;
+        for (int b = 0; b < BRANCHES; b++) {
+            if (v < b * stride || v >= b * stride + perBranch) continue;
+            benchMergeDate(b, v, date);
+            if (dateKey(date) > expected) expected = dateKey(date);
+        }
+        benchVehicleNumber((uint64_t)v, vehicleNumber);
+        normalizePlate(vehicleNumber, vehicleNumber);
+        ServiceRecord* found = findVehicle(vehicleNumber);
+        wrong += found == NULL || dateKey(found->date) != expected;
+    }
+    printf("Output check: %zu records, %ld wrong or missing, %s\n", columns.count, wrong,
+           wrong == 0 && columns.count == (size_t)vehicles ? "ok" : "MISMATCH");
+    freeList(&head);
+
+    static const char* suffixes[] = { "", ".dict", ".hist", ".due", ".idx" };
+    for (int f = 0; f <= BRANCHES; f++) {
+        for (int x = 0; x < 5; x++) {
+            snprintf(path, sizeof(path), "%s%s", f < BRANCHES ? paths[f] : output, suffixes[x]);
+            unlink(path);
+        }
+    }
+}
+
+// One writer thread's records: all of one region
+typedef struct BenchShardWriter {
+    ServiceRecord** records;
+    long count;
+} BenchShardWriter;
+
+static void* benchShardWriterThread(void* arg) {
+    BenchShardWriter* writer = (BenchShardWriter*)arg;
+    for (long i = 0; i < writer->count; i++) storeWriteTombstone(writer->records[i]);
+    return NULL;
+}
+
+// Save and load time as the region shard count grows, and the throughput of
+// eight writers, one per region, each writing tombstones for its own vehicles.
+// Each layout runs in its own process so earlier ones leave no heap behind.
+static void benchShards(long records) {
+    enum { REGIONS = 8, WRITES_EACH = 20000 };
+    static const int shardCounts[] = { 1, 2, 4, 8 };
+    char filename[64], path[320];
+    snprintf(filename, sizeof(filename), "/tmp/service_bench_shards.%d.dat", (int)getpid());
+    printf("%ld records, %d regions, %ld CPUs\n", records, REGIONS, sysconf(_SC_NPROCESSORS_ONLN));
+    fflush(stdout);
+
+    for (size_t c = 0; c < sizeof(shardCounts) / sizeof(shardCounts[0]); c++) {
+        if (fork() == 0) {
+            setShardLayout(shardCounts[c], SHARD_BY_REGION);
+            ServiceRecord* head = benchBuildList(records);
+            double start = benchNow();
+            saveToFile(head, filename);
+            double saveSeconds = benchNow() - start;
+            freeList(&head);
+            start = benchNow();
+            loadFromFile(&head, filename);
+            double loadSeconds = benchNow() - start;
+
+            // benchVehicleNumber gives vehicle n the region n % 8
+            BenchShardWriter writers[REGIONS];
+            pthread_t threads[REGIONS];
+            long perWriter = records / REGIONS < WRITES_EACH ? records / REGIONS : WRITES_EACH;
+            for (int r = 0; r < REGIONS; r++) {
+                writers[r].records = (ServiceRecord**)malloc((perWriter + 1) * sizeof(ServiceRecord*));
+                writers[r].count = 0;
+            }
+            char vehicleNumber[20];
+            for (long n = 0; n < perWriter * REGIONS; n++) {
+                benchVehicleNumber((uint64_t)n, vehicleNumber);
+                BenchShardWriter* writer = &writers[n % REGIONS];
+                writer->records[writer->count++] = findVehicle(vehicleNumber);
+            }
+            start = benchNow();
+            for (int r = 0; r < REGIONS; r++) {
+                pthread_create(&threads[r], NULL, benchShardWriterThread, &writers[r]);
+            }
+            for (int r = 0; r < REGIONS; r++) pthread_join(threads[r], NULL);
+            double writeSeconds = benchNow() - start;
+
+            uint64_t largest = 0;
+            for (int shard = 0; shard < shardCounts[c]; shard++) {
+                if (recordStores[shard].slotCount > largest) largest = recordStores[shard].slotCount;
+            }
+            printf("%d shard(s): save %.3f s, load %.3f s, largest shard %.0f%%, "
+                   "%d writers %.0f tombstones/s\n", shardCounts[c], saveSeconds, loadSeconds,
+                   100.0 * largest / records, REGIONS, perWriter * REGIONS / writeSeconds);
+            fflush(stdout);
+            _exit(0);
+        }
+        int status;
+        wait(&status);
+
+        // Every layout starts from no files; replacing one costs the file system extra flushes
+        ShardLayout layout = { (uint32_t)shardCounts[c], SHARD_BY_REGION };
+        for (int shard = 0; shard < shardCounts[c]; shard++) {
+            shardFilePath(filename, &layout, (uint32_t)shard, path, sizeof(path));
+            unlink(path);
+        }
+        static const char* suffixes[] = { ".shards", ".dict", ".hist", ".due", ".idx" };
+        for (int x = 0; x < 5; x++) {
+            snprintf(path, sizeof(path), "%s%s", filename, suffixes[x]);
+            unlink(path);
+        }
+    }
+}
+
+// Synthetic live slot: a fixed record with the slot number in its plate
+static void benchIoFill(void* context, uint64_t slot, DiskRecord* disk) {
+    memcpy(disk, context, sizeof(DiskRecord));
+    memcpy(disk->vehicleNumber + 4, &slot, sizeof(slot));
+    disk->costCents = 10000 + (int64_t)(slot * 7919 % 90000);
+}
+
+typedef struct BenchIoScan {
+    uint64_t live;
+    uint64_t corrupt;
+    int64_t total;
+} BenchIoScan;
+
+// Light parsing for the read side: count live slots and add up their costs
+static void benchIoVisit(void* context, uint64_t firstSlot, const DiskRecord* slots, uint32_t count,
+                         int intact) {
+    BenchIoScan* scan = (BenchIoScan*)context;
+    (void)firstSlot;
+    if (!intact) {
+        scan->corrupt++;
+        return;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        if (slots[i].flags != SLOT_LIVE) continue;
+        scan->live++;
+        scan->total += slots[i].costCents;
+    }
+}
+
+// Compaction time for one I/O mode, in a process of its own
+static void benchIoCompaction(int mode, long records) {
+    fflush(stdout);
+    if (fork() != 0) {
+        int status;
+        wait(&status);
+        return;
+    }
+    char filename[64], dictPath[80];
+    snprintf(filename, sizeof(filename), "/tmp/service_bench_io_compact.%d.dat", (int)getpid());
+    snprintf(dictPath, sizeof(dictPath), "%s.dict", filename);
+    ioMode = mode;
+    ServiceRecord* head = benchBuildList(records);
+    saveToFile(head, filename);
+    ServiceRecord* current = head;
+    for (long index = 0; current != NULL; index++) {
+        ServiceRecord* next = current->next;
+        if (index % 3 == 0) removeRecord(&head, current);
+        current = next;
+    }
+    double start = benchNow();
+    size_t segments = compactRecordStore(SIZE_MAX);
+    double seconds = benchNow() - start;
+    printf("  compact %-6s %zu segments of %ld records in %.3f s (%.1f MB/s rewritten)\n",
+           ioModeNames[mode], segments, records, seconds, recordStores[0].bytesRewritten / seconds / 1e6);
+    fflush(stdout);
+    freeList(&head);
+    unlink(filename);
+    unlink(dictPath);
+    _exit(0);
+}
+
+// Write and read a record file of the given number of slots (about 2.5 GB
+// by default) through each I/O mode. Reads start cold: the file is dropped
+// from the page cache first. Compaction of a 1M-record file is timed with
+// pread/pwrite and with io_uring.
+static void benchIo(long slots) {
+    char filename[64], tempPath[80];
+    snprintf(filename, sizeof(filename), "/tmp/service_bench_io.%d.dat", (int)getpid());
+    DiskRecord template;
+    memset(&template, 0, sizeof(template));
+    memcpy(template.vehicleNumber, "BNCH", 4);
+    memcpy(template.date, "01-01-2025", 10);
+    setSlotFlags(&template, SLOT_LIVE);
+    double megabytes = recordFileSize((uint64_t)slots) / 1e6;
+    printf("%ld slots, %.0f MB record file\n", slots, megabytes);
+
+    for (int mode = IO_MODE_STDIO; mode >= IO_MODE_URING; mode--) {
+        ioMode = mode;
+        unlink(filename);
+        double start = benchNow();
+        FILE* file = openTempFile(filename, tempPath, sizeof(tempPath));
+        int ok = file != NULL && writeRecordSegments(file, (uint64_t)slots, 1, benchIoFill, &template) &&
+                 commitTempFile(file, tempPath, filename);
+        double writeSeconds = benchNow() - start;
+
+        file = fopen(filename, "rb");
+        if (!ok || file == NULL) {
+            printf("%s: writing %s failed\n", ioModeNames[mode], filename);
+            if (file != NULL) fclose(file);
+            continue;
+        }
+        posix_fadvise(fileno(file), 0, 0, POSIX_FADV_DONTNEED);
+        BenchIoScan cold = { 0, 0, 0 }, warm = { 0, 0, 0 };
+        start = benchNow();
+        readRecordSegments(file, (uint64_t)slots, benchIoVisit, &cold);
+        double coldSeconds = benchNow() - start;
+        start = benchNow();
+        readRecordSegments(file, (uint64_t)slots, benchIoVisit, &warm);
+        double warmSeconds = benchNow() - start;
+        fclose(file);
+        printf("%-6s write %7.1f MB/s (fsync included), read cold %7.1f MB/s, warm %7.1f MB/s%s\n",
+               ioModeNames[mode], megabytes / writeSeconds, megabytes / coldSeconds, megabytes / warmSeconds,
+               cold.live == (uint64_t)slots && cold.corrupt == 0 && warm.total == cold.total ? "" : " MISMATCH");
+    }
+    ioMode = IO_MODE_URING;
+    printf("File I/O with --io uring here: %s\n", ioModeDescription());
+    unlink(filename);
+
+    benchIoCompaction(IO_MODE_PREAD, 1000000);
+    benchIoCompaction(IO_MODE_URING, 1000000);
+}
+
+typedef struct BenchIndexDigest {
+    int which;
+    int64_t previous;
+    int ordered;
+    uint64_t sum;
+} BenchIndexDigest;
+
+// Order-independent sum over a tree's entries, and whether its keys ascend
+static void benchIndexVisit(ServiceRecord* record, void* context) {
+    BenchIndexDigest* digest = (BenchIndexDigest*)context;
+    int64_t key = orderIndexKey(digest->which, record);
+    if (key < digest->previous) digest->ordered = 0;
+    digest->previous = key;
+    digest->sum += hashString64(record->vehicleNumber) * (uint64_t)(2 * digest->which + 1) ^ (uint64_t)key;
+}
+
+// Drop a file from the page cache so the next load reads it from disk
+static void benchDropCache(const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return;
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+}
+
+// Load the saved file cold in a child and report its load time, its first
+// lookup and a digest of the order trees and vehicle lookups
+static uint64_t benchIndexLoad(const char* filename, const char* label, long records) {
+    static const char* suffixes[] = { "", ".dict", ".hist", ".due", ".idx" };
+    char path[320];
+    int pipeFds[2];
+    uint64_t digest = 0;
+    if (pipe(pipeFds) != 0) return 0;
+    fflush(stdout);
+    if (fork() == 0) {
+        for (int x = 0; x < 5; x++) {
+            snprintf(path, sizeof(path), "%s%s", filename, suffixes[x]);
+            benchDropCache(path);
+        }
+        ServiceRecord* head = NULL;
+        char vehicleNumber[20];
+        double start = benchNow();
+        loadFromFile(&head, filename);
+        double loadSeconds = benchNow() - start;
+        benchVehicleNumber((uint64_t)records / 2, vehicleNumber);
+        start = benchNow();
+        int found = findVehicle(vehicleNumber) != NULL;
+        double lookupSeconds = benchNow() - start;
+
+        int ordered = 1;
+        for (int which = 1; which <= INDEX_TREES; which++) {
+            BenchIndexDigest tree = { which, INT64_MIN, 1, 0 };
+            orderTreeRange(orderIndexTree(which), INT64_MIN, INT64_MAX, benchIndexVisit, &tree);
+            digest = digest * 31 + tree.sum + orderTreeCount(orderIndexTree(which));
+            ordered = ordered && tree.ordered;
+        }
+        long hits = 0;
+        for (long n = 0; n < records; n += 97) {
+            benchVehicleNumber((uint64_t)n, vehicleNumber);
+            hits += findVehicle(vehicleNumber) != NULL;
+        }
+        digest = digest * 31 + (uint64_t)hits;
+        printf("%-22s load %.3f s (indexes %s in %.3f s, %d rebuilt), first lookup %.1f us%s%s\n", label,
+               loadSeconds, indexLoadStats.adopted ? "adopted" : "built", indexLoadStats.seconds,
+               indexLoadStats.rebuiltParts, lookupSeconds * 1e6, found ? "" : " MISSING",
+               ordered ? "" : " TREE OUT OF ORDER");
+        fflush(stdout);
+        if (write(pipeFds[1], &digest, sizeof(digest)) != sizeof(digest)) _exit(1);
+        _exit(0);
+    }
+    close(pipeFds[1]);
+    if (read(pipeFds[0], &digest, sizeof(digest)) != sizeof(digest)) digest = 0;
+    close(pipeFds[0]);
+    int status;
+    wait(&status);
+    return digest;
+}
+
+// Cold start with and without the persisted index file: one save, then a
+// load of the same files in a fresh process each way. The two loads must
+// end up with the same trees and vehicle lookups.
+static void benchIndex(long records) {
+    static const char* suffixes[] = { "", ".dict", ".hist", ".due", ".idx" };
+    char filename[64], path[320], hidden[330];
+    snprintf(filename, sizeof(filename), "/tmp/service_bench_index.%d.dat", (int)getpid());
+    fflush(stdout);
+    if (fork() == 0) {
+        ServiceRecord* head = benchBuildList(records);
+        double start = benchNow();
+        saveToFile(head, filename);
+        printf("%ld records saved in %.3f s\n", records, benchNow() - start);
+        fflush(stdout);
+        _exit(0);
+    }
+    int status;
+    wait(&status);
+    snprintf(path, sizeof(path), "%s.idx", filename);
+    struct stat st;
+    if (stat(path, &st) == 0) printf("Index file: %.1f MB\n", st.st_size / 1e6);
+
+    uint64_t adopted = benchIndexLoad(filename, "With index file:", records);
+    snprintf(hidden, sizeof(hidden), "%s.off", path);
+    rename(path, hidden);
+    uint64_t built = benchIndexLoad(filename, "Without index file:", records);
+    rename(hidden, path);
+    printf("Trees and lookups %s\n", adopted == built && adopted != 0 ? "match" : "MISMATCH");
+    for (int x = 0; x < 5; x++) {
+        snprintf(path, sizeof(path), "%s%s", filename, suffixes[x]);
+        unlink(path);
+    }
+}
+
+// Lookups through the lazy record cache at several cache sizes, with
+// vehicle popularity skewed as in the ops suite: hit rate and latency once
+// the cache has warmed up. The record file stays in the page cache, so a
+// miss costs reading and checking one segment rather than a disk seek.
+// Then a listing in file order, which reads ahead, against one in reverse.
+static void benchLazy(long records) {
+    enum { LOOKUPS = 200000 };
+    static const double cachePercents[] = { 1, 5, 20, 100 };
+    char filename[64], path[80], vehicleNumber[20];
+    snprintf(filename, sizeof(filename), "/tmp/service_bench_lazy.%d.dat", (int)getpid());
+    fflush(stdout);
+    if (fork() == 0) {
+        ServiceRecord* head = benchBuildList(records);
+        saveToFile(head, filename);
+        _exit(0);
+    }
+    int status;
+    wait(&status);
+    struct stat st;
+    if (stat(filename, &st) != 0) {
+        printf("Saving %s failed\n", filename);
+        return;
+    }
+
+    double start = benchNow();
+    RecordCache* cache = recordCacheOpen(filename, 1);
+    double openSeconds = benchNow() - start;
+    printf("%ld records, %.1f MB record file, opened lazily in %.3f s\n", records, st.st_size / 1e6, openSeconds);
+    printf("Resident plate index: %.1f MB (%zu bytes per record for a full load's records alone)\n",
+           cache->plateCapacity * sizeof(PlateLocation) / 1e6, sizeof(ServiceRecord));
+    recordCacheClose(cache);
+
+    double* samples = (double*)malloc(LOOKUPS * sizeof(double));
+    for (size_t c = 0; c < sizeof(cachePercents) / sizeof(cachePercents[0]); c++) {
+        size_t bytes = (size_t)(records * cachePercents[c] / 100) * sizeof(CachedRecord);
+        cache = recordCacheOpen(filename, bytes);
+        uint64_t rng = 0x9E3779B97F4A7C15ULL;
+        long found = 0;
+        for (int pass = 0; pass < 2; pass++) {
+            cache->hits = cache->misses = cache->reads = 0;
+            for (long i = 0; i < LOOKUPS; i++) {
+                uint64_t rank = benchZipf(&rng, (uint64_t)records, BENCH_ZIPF_EXPONENT);
+                benchVehicleNumber(benchRankToVehicle(rank, (uint64_t)records), vehicleNumber);
+                double t = benchNow();
+                found += recordCacheFind(cache, vehicleNumber) != NULL;
+                samples[i] = benchNow() - t;
+            }
+        }
+        qsort(samples, LOOKUPS, sizeof(double), benchCompareDouble);
+        printf("Cache %5.1f%% (%7.1f MB): hit rate %5.1f%%, p50 %6.2f us, p99 %6.2f us, %llu segment reads%s\n",
+               cachePercents[c], bytes / 1e6, 100.0 * cache->hits / LOOKUPS,
+               benchPercentile(samples, LOOKUPS, 0.50) * 1e6, benchPercentile(samples, LOOKUPS, 0.99) * 1e6,
+               (unsigned long long)cache->reads, found == 2 * LOOKUPS ? "" : " MISSING");
+        recordCacheClose(cache);
+    }
+    free(samples);
+
+    cache = recordCacheOpen(filename, (size_t)(records / 100 + 1) * sizeof(CachedRecord));
+    for (int reverse = 0; reverse < 2; reverse++) {
+        uint64_t slots = cache->slotCounts[0], listed = 0, readsBefore = cache->reads;
+        start = benchNow();
+        for (uint64_t i = 0; i < slots; i++) {
+            listed += recordCacheSlot(cache, 0, reverse ? slots - 1 - i : i) != NULL;
+        }
+        printf("Listing in %s order: %.3f s, %llu records, %llu segment reads\n", reverse ? "reverse" : "file",
+               benchNow() - start, (unsigned long long)listed, (unsigned long long)(cache->reads - readsBefore));
+    }
+    recordCacheClose(cache);
+
+    static const char* suffixes[] = { "", ".dict", ".hist", ".due", ".idx" };
+    for (int x = 0; x < 5; x++) {
+        snprintf(path, sizeof(path), "%s%s", filename, suffixes[x]);
+        unlink(path);
+    }
+}
+
+// Edits while saving and exporting: a blocking save holds the menu for the
+// whole write, a snapshot save only for taking the snapshot. While the
+// background save runs, the main thread keeps updating (90%), deleting and
+// adding vehicles, timing each kind of edit. Then the memory the snapshot
+// kept, a check that the saved file holds the records as of the snapshot,
+// and the same for an export.
+static void benchSnapshot(long records) {
+    enum { MAX_EDITS = 4000000 };
+    static const char* editNames[] = { "update", "delete", "add" };
+    const int64_t marker = 1000000000;  // added to the cost of records updated during a job
+    char filename[64], path[80], vehicleNumber[20];
+    snprintf(filename, sizeof(filename), "/tmp/service_bench_snapshot.%d.dat", (int)getpid());
+    ServiceRecord* head = benchBuildList(records);
+
+    double start = benchNow();
+    saveToFile(head, filename);
+    printf("%ld records, blocking save: %.3f s with edits held up\n", records, benchNow() - start);
+
+    double* samples[3];
+    for (int e = 0; e < 3; e++) samples[e] = (double*)malloc(MAX_EDITS * sizeof(double));
+    long added = 0;
+    for (int kind = JOB_SAVE; kind <= JOB_EXPORT; kind++) {
+        const char* target = filename;
+        if (kind == JOB_EXPORT) {
+            snprintf(path, sizeof(path), "%s.csv", filename);
+            target = path;
+        }
+        int64_t jobMarker = marker * (kind + 1);
+        uint64_t preservedBefore = snapshotStats.preserved, parkedBefore = snapshotStats.parked;
+        snapshotStats.peakBytes = 0;
+        size_t expected = columns.count, edits[3] = { 0, 0, 0 }, deleted = 0;
+        start = benchNow();
+        startBackgroundJob(kind, head, target);
+        double takeSeconds = benchNow() - start;
+
+        uint64_t rng = 0x9E3779B97F4A7C15ULL + (uint64_t)kind;
+        start = benchNow();
+        while (!__atomic_load_n(&backgroundJob.done, __ATOMIC_ACQUIRE) && edits[0] < MAX_EDITS) {
+            uint64_t pick = benchRand(&rng) % 20, vehicle = benchRand(&rng) % (uint64_t)records;
+            int e = pick < 18 ? 0 : pick == 18 ? 1 : 2;
+            double t = benchNow();
+            benchVehicleNumber(vehicle, vehicleNumber);
+            if (e == 0) {
+                ServiceRecord* record = findVehicle(vehicleNumber);
+                if (record != NULL) modifyRecord(record, NULL, NULL, NULL, jobMarker + record->costCents % marker);
+            } else if (e == 1) {
+                deleted += removeVehicle(&head, vehicleNumber);
+            } else {
+                benchInsertVehicle(&head, (uint64_t)records + added++, (uint64_t)records, &rng, 1);
+            }
+            samples[e][edits[e]++] = benchNow() - t;
+        }
+        double editSeconds = benchNow() - start;
+        finishBackgroundJob(1);
+        printf("%s: snapshot taken in %.1f us, %zu edits in the %.2f s it ran\n",
+               kind == JOB_SAVE ? "Background save" : "Background export", takeSeconds * 1e6,
+               edits[0] + edits[1] + edits[2], editSeconds);
+        for (int e = 0; e < 3; e++) {
+            if (edits[e] == 0) continue;
+            qsort(samples[e], edits[e], sizeof(double), benchCompareDouble);
+            printf("  %-6s x%-7zu p50 %8.2f us, p99 %8.2f us, max %9.1f us\n", editNames[e], edits[e],
+                   benchPercentile(samples[e], edits[e], 0.50) * 1e6,
+                   benchPercentile(samples[e], edits[e], 0.99) * 1e6, samples[e][edits[e] - 1] * 1e6);
+        }
+        printf("  Snapshot kept %llu records (%llu deletes parked), copy table peak %.2f MB\n",
+               (unsigned long long)(snapshotStats.preserved - preservedBefore),
+               (unsigned long long)(snapshotStats.parked - parkedBefore), snapshotStats.peakBytes / 1e6);
+
+        // The file or export must hold the records as of the snapshot; deletes
+        // are written to the record file as they happen, so they show there
+        size_t found = 0, changed = 0;
+        if (kind == JOB_SAVE) {
+            fflush(stdout);
+            if (fork() == 0) {
+                freeList(&head);
+                loadFromFile(&head, filename);
+                for (ServiceRecord* r = head; r != NULL; r = r->next) {
+                    found++;
+                    changed += r->costCents >= jobMarker;
+                }
+                printf("  Saved file: %zu records (%zu in the snapshot less %zu deleted since), "
+                       "%zu with later updates\n", found, expected, deleted, changed);
+                fflush(stdout);
+                _exit(0);
+            }
+            int status;
+            wait(&status);
+        } else {
+            FILE* file = fopen(path, "r");
+            char line[256];
+            while (file != NULL && fgets(line, sizeof(line), file) != NULL) {
+                found++;
+                changed += atof(strrchr(line, ',') + 1) >= jobMarker / 100.0;
+            }
+            if (file != NULL) fclose(file);
+            printf("  Export: %zu records (%zu in the snapshot), %zu with later updates\n",
+                   found > 0 ? found - 1 : 0, expected, changed);
+            unlink(path);
+        }
+    }
+    for (int e = 0; e < 3; e++) free(samples[e]);
+    freeList(&head);
+
+    static const char* suffixes[] = { "", ".dict", ".hist", ".due", ".idx" };
+    for (int x = 0; x < 5; x++) {
+        snprintf(path, sizeof(path), "%s%s", filename, suffixes[x]);
+        unlink(path);
+    }
+}
+
+// Foreground edit latency while autosave checkpoints run, against edits
+// between checkpoints, and what each checkpoint writes against a full save
+static void benchAutosave(long records) {
+    enum { MAX_EDITS = 4000000 };
+    static const char* editNames[] = { "update", "delete", "add" };
+    const int64_t marker = 1000000000;  // added to the cost of every updated record
+    const double runSeconds = 6;
+    char filename[64], path[80], vehicleNumber[20];
+    snprintf(filename, sizeof(filename), "/tmp/service_bench_autosave.%d.dat", (int)getpid());
+    ServiceRecord* head = benchBuildList(records);
+
+    double start = benchNow();
+    saveToFile(head, filename);
+    double saveSeconds = benchNow() - start;
+    printf("%ld records, full save: %.3f s, %.1f MB\n", records, saveSeconds,
+           records * (double)sizeof(DiskRecord) / 1e6);
+
+    autosave.seconds = 1;
+    autosave.bytes = 4 << 20;
+    startAutosave(&head, filename);
+
+    // samples[during][edit]: whether a checkpoint was being written when the edit ran
+    double* samples[2][3];
+    size_t edits[2][3] = { { 0 } };
+    for (int d = 0; d < 2; d++) {
+        for (int e = 0; e < 3; e++) samples[d][e] = (double*)malloc(MAX_EDITS * sizeof(double));
+    }
+    uint64_t rng = 0x9E3779B97F4A7C15ULL;
+    long added = 0;
+    size_t deleted = 0, total = 0;
+    start = benchNow();
+    while (benchNow() - start < runSeconds && total < MAX_EDITS) {
+        uint64_t pick = benchRand(&rng) % 20, vehicle = benchRand(&rng) % (uint64_t)records;
+        int e = pick < 18 ? 0 : pick == 18 ? 1 : 2;
+        double t = benchNow();
+        pthread_mutex_lock(&commandLock);
+        int during = __atomic_load_n(&autosave.writing, __ATOMIC_ACQUIRE);
+        benchVehicleNumber(vehicle, vehicleNumber);
+        if (e == 0) {
+            ServiceRecord* record = findVehicle(vehicleNumber);
+            if (record != NULL) modifyRecord(record, NULL, NULL, NULL, marker + record->costCents % marker);
+        } else if (e == 1) {
+            deleted += removeVehicle(&head, vehicleNumber);
+        } else {
+            benchInsertVehicle(&head, (uint64_t)records + added++, (uint64_t)records, &rng, 1);
+        }
+        pthread_mutex_unlock(&commandLock);
+        samples[during][e][edits[during][e]++] = benchNow() - t;
+        total++;
+    }
+    double editSeconds = benchNow() - start;
+    stopAutosave();
+
+    printf("%zu edits in %.2f s (%zu deletes, %ld adds) with autosave every %.0f s or %.0f MB dirty\n",
+           total, editSeconds, deleted, added, autosave.seconds, autosave.bytes / 1048576.0);
+    for (int d = 1; d >= 0; d--) {
+        printf("  %s:\n", d ? "While a checkpoint was written" : "Between checkpoints");
+        for (int e = 0; e < 3; e++) {
+            size_t n = edits[d][e];
+            if (n == 0) continue;
+            qsort(samples[d][e], n, sizeof(double), benchCompareDouble);
+            printf("    %-6s x%-7zu p50 %8.2f us, p99 %8.2f us, max %9.1f us\n", editNames[e], n,
+                   benchPercentile(samples[d][e], n, 0.50) * 1e6,
+                   benchPercentile(samples[d][e], n, 0.99) * 1e6, samples[d][e][n - 1] * 1e6);
+        }
+    }
+    for (int d = 0; d < 2; d++) {
+        for (int e = 0; e < 3; e++) free(samples[d][e]);
+    }
+    uint64_t incremental = autosave.checkpoints - autosave.fullSaves;
+    if (incremental > 0) {
+        printf("Checkpoints: %llu (%llu full), %llu segments rewritten and %llu records appended\n",
+               (unsigned long long)autosave.checkpoints, (unsigned long long)autosave.fullSaves,
+               (unsigned long long)autosave.segmentsWritten, (unsigned long long)autosave.recordsAppended);
+        printf("  %.2f MB and %.3f s per checkpoint on average, against %.3f s for a full save\n",
+               autosave.bytesWritten / 1e6 / incremental, autosave.writeSeconds / autosave.checkpoints,
+               saveSeconds);
+    }
+
+    // A last checkpoint catches the files up; loading them must then give
+    // the list as it is, without the save a normal exit would do
+    start = benchNow();
+    int ok = checkpointRecords(&head, filename);
+    printf("Final checkpoint: %s in %.3f s\n", ok ? "written" : "failed", benchNow() - start);
+    size_t expected = 0, expectedChanged = 0;
+    int64_t expectedSum = 0;
+    for (ServiceRecord* r = head; r != NULL; r = r->next) {
+        expected++;
+        expectedChanged += r->costCents >= marker;
+        expectedSum += r->costCents;
+    }
+    fflush(stdout);
+    if (fork() == 0) {
+        size_t found = 0, changed = 0;
+        int64_t sum = 0;
+        freeList(&head);
+        loadFromFile(&head, filename);
+        for (ServiceRecord* r = head; r != NULL; r = r->next) {
+            found++;
+            changed += r->costCents >= marker;
+            sum += r->costCents;
+        }
+        printf("Reloaded: %zu records (%zu in memory), %zu updated (%zu), cost sum %s\n", found, expected,
+               changed, expectedChanged, sum == expectedSum ? "matches" : "DIFFERS");
+        fflush(stdout);
+        _exit(0);
+    }
+    int status;
+    wait(&status);
+    freeList(&head);
+
+    static const char* suffixes[] = { "", ".dict", ".hist", ".due", ".idx", ".checkpoint" };
+    for (int x = 0; x < 6; x++) {
+        snprintf(path, sizeof(path), "%s%s", filename, suffixes[x]);
+        unlink(path);
+    }
+}
+
+// One thread of the mixed date-index load. A writer owns a slice of the
+// records and keeps half of it indexed, inserting one record and removing
+// the oldest in turn; a reader counts the records of a random month.
+typedef struct BenchIndexThread {
+    DateSkipList* list;             // NULL: the mutex-protected tree
+    OrderTree* tree;
+    pthread_mutex_t* lock;
+    ServiceRecord** records;
+    size_t first, count;            // a writer's slice
+    int writer;
+    int* stop;
+    uint64_t ops;
+    uint64_t visited;               // records the scans counted
+} BenchIndexThread;
+
+static void* benchIndexThread(void* arg) {
+    BenchIndexThread* t = (BenchIndexThread*)arg;
+    uint64_t rng = 0x9E3779B97F4A7C15ULL ^ (uint64_t)(uintptr_t)t;
+    size_t oldest = 0, half = t->count / 2;
+    while (!__atomic_load_n(t->stop, __ATOMIC_ACQUIRE)) {
+        if (t->writer) {
+            ServiceRecord* added = t->records[t->first + (oldest + half) % t->count];
+            ServiceRecord* removed = t->records[t->first + oldest % t->count];
+            oldest++;
+            if (t->list != NULL) {
+                dateSkipListInsert(t->list, added);
+                dateSkipListRemove(t->list, removed);
+            } else {
+                int64_t addedKey = dateKey(added->date), removedKey = dateKey(removed->date);
+                pthread_mutex_lock(t->lock);
+                orderTreeInsert(t->tree, addedKey, added);
+                pthread_mutex_unlock(t->lock);
+                pthread_mutex_lock(t->lock);
+                orderTreeRemove(t->tree, removedKey, removed);
+                pthread_mutex_unlock(t->lock);
+            }
+            t->ops += 2;
+        } else {
+            uint64_t month = benchRand(&rng) % 48;
+            int64_t from = (2022 + (int64_t)month / 12) * 10000 + (int64_t)(month % 12 + 1) * 100 + 1;
+            size_t visited = 0;
+            if (t->list != NULL) {
+                dateSkipListRange(t->list, from, from + 30, benchCountVisit, &visited);
+            } else {
+                pthread_mutex_lock(t->lock);
+                orderTreeRange(t->tree, from, from + 30, benchCountVisit, &visited);
+                pthread_mutex_unlock(t->lock);
+            }
+            t->visited += visited;
+            t->ops++;
+        }
+    }
+    return NULL;
+}
+
+// Range visitor for the checks: entries must come in (date, plate) order
+static void benchSkipOrderVisit(ServiceRecord* record, void* context) {
+    ServiceRecord** previous = (ServiceRecord**)context;
+    if (*previous != NULL) {
+        int64_t a = dateKey((*previous)->date), b = dateKey(record->date);
+        int plates = memcmp((*previous)->vehicleNumber, record->vehicleNumber, PLATE_KEY_SIZE);
+        if (a > b || (a == b && plates >= 0)) {
+            printf("  Skip list out of order at %s\n", record->vehicleNumber);
+        }
+    }
+    *previous = record;
+}
+
+// Writes/s and month scans/s of the lock-free skip list against an order
+// tree behind one mutex, with writers inserting and removing while readers
+// scan. Half of `records` are indexed at any time.
+static void benchSkipList(long records) {
+    static const int mixes[][2] = { { 1, 1 }, { 2, 2 }, { 4, 4 }, { 1, 7 }, { 7, 1 } };
+    const double runSeconds = 1;
+    ServiceRecord** all = (ServiceRecord**)malloc(records * sizeof(ServiceRecord*));
+    char vehicleNumber[20], date[11];
+    uint64_t rng = 42;
+    for (long i = 0; i < records; i++) {
+        benchVehicleNumber((uint64_t)i, vehicleNumber);
+        snprintf(date, sizeof(date), "%02d-%02d-%d", (int)(benchRand(&rng) % 28) + 1,
+                 (int)(benchRand(&rng) % 12) + 1, 2022 + (int)(benchRand(&rng) % 4));
+        all[i] = createRecord(vehicleNumber, "Bench Owner", (char*)benchServiceTypes[i % BENCH_SERVICE_TYPES],
+                              date, 10000);
+    }
+    // The tree breaks ties on record address; shuffled, neither index is fed in memory order
+    for (long i = records - 1; i > 0; i--) {
+        long j = (long)(benchRand(&rng) % (uint64_t)(i + 1));
+        ServiceRecord* swap = all[i];
+        all[i] = all[j];
+        all[j] = swap;
+    }
+    printf("Date index under mixed load: %ld records, half indexed; writers insert and remove, "
+           "readers count one month\n", records);
+
+    for (size_t m = 0; m < sizeof(mixes) / sizeof(mixes[0]); m++) {
+        int writers = mixes[m][0], threads = writers + mixes[m][1];
+        double rates[2][3];
+        for (int skip = 1; skip >= 0; skip--) {
+            DateSkipList* list = skip ? dateSkipListCreate() : NULL;
+            OrderTree tree = { NULL };
+            pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+            BenchIndexThread work[8];
+            pthread_t ids[8];
+            int stop = 0;
+            for (int t = 0; t < threads; t++) {
+                BenchIndexThread* w = &work[t];
+                memset(w, 0, sizeof(*w));
+                w->list = list;
+                w->tree = &tree;
+                w->lock = &lock;
+                w->records = all;
+                w->writer = t < writers;
+                w->stop = &stop;
+                if (!w->writer) continue;
+                w->first = (size_t)records * t / writers;
+                w->count = (size_t)records * (t + 1) / writers - w->first;
+                for (size_t i = 0; i < w->count / 2; i++) {
+                    if (skip) dateSkipListInsert(list, all[w->first + i]);
+                    else orderTreeInsert(&tree, dateKey(all[w->first + i]->date), all[w->first + i]);
+                }
+            }
+            for (int t = 0; t < threads; t++) pthread_create(&ids[t], NULL, benchIndexThread, &work[t]);
+            usleep((useconds_t)(runSeconds * 1e6));
+            __atomic_store_n(&stop, 1, __ATOMIC_RELEASE);
+            uint64_t writes = 0, scans = 0, visited = 0;
+            for (int t = 0; t < threads; t++) {
+                pthread_join(ids[t], NULL);
+                if (work[t].writer) writes += work[t].ops;
+                else scans += work[t].ops;
+                visited += work[t].visited;
+            }
+            rates[skip][0] = writes / runSeconds;
+            rates[skip][1] = scans / runSeconds;
+            rates[skip][2] = scans > 0 ? (double)visited / scans : 0;
+
+            size_t expected = 0;
+            for (int t = 0; t < writers; t++) expected += work[t].count / 2;
+            if (skip) {
+                ServiceRecord* previous = NULL;
+                size_t found = dateSkipListRange(list, INT64_MIN, INT64_MAX, benchSkipOrderVisit, &previous);
+                size_t freed = dateSkipListReclaim(list);
+                if (found != expected || list->count != expected) {
+                    printf("  Skip list holds %zu entries (count %llu), expected %zu\n", found,
+                           (unsigned long long)list->count, expected);
+                }
+                if (freed != writes / 2) printf("  Reclaimed %zu nodes, expected %llu\n", freed,
+                                                (unsigned long long)(writes / 2));
+                dateSkipListFree(list);
+            } else {
+                if (orderTreeCount(&tree) != expected) {
+                    printf("  Tree holds %zu entries, expected %zu\n", orderTreeCount(&tree), expected);
+                }
+                orderTreeFree(&tree);
+            }
+        }
+        printf("  %d writer%s + %d reader%s: skip list %9.0f writes/s %7.0f scans/s | "
+               "mutex tree %9.0f writes/s %7.0f scans/s | %.0f records per scan\n",
+               writers, writers == 1 ? " " : "s", threads - writers, threads - writers == 1 ? " " : "s",
+               rates[1][0], rates[1][1], rates[0][0], rates[0][1], rates[1][2]);
+    }
+    for (long i = 0; i < records; i++) free(all[i]);
+    free(all);
+}
+
+// Report reads from the revenue rollups against scans of the records, the
+// cost of keeping them current on each edit, and a rebuild-and-compare check
+static void benchRollups(long records) {
+    uint64_t rng = 0x9E3779B97F4A7C15ULL ^ (uint64_t)records;
+    ServiceRecord* head = NULL;
+    for (uint64_t v = 0; v < (uint64_t)records; v++) benchInsertVehicle(&head, v, records, &rng, 0);
+    size_t* counts[2];
+    int64_t* totals[2];
+    for (int i = 0; i < 2; i++) {
+        counts[i] = (size_t*)calloc(serviceTypes.count + 1, sizeof(size_t));
+        totals[i] = (int64_t*)calloc(serviceTypes.count + 1, sizeof(int64_t));
+    }
+    int scans = 5, reads = 100000;
+
+    // Revenue by service type for 2025: a scan against the month rows
+    double start = benchNow();
+    for (int i = 0; i < scans; i++) {
+        memset(counts[0], 0, (serviceTypes.count + 1) * sizeof(size_t));
+        memset(totals[0], 0, (serviceTypes.count + 1) * sizeof(int64_t));
+        summarizeServiceTypes(20250101, 20251231, counts[0], totals[0]);
+    }
+    double scanSeconds = (benchNow() - start) / scans;
+    start = benchNow();
+    for (int i = 0; i < reads; i++) {
+        memset(counts[1], 0, (serviceTypes.count + 1) * sizeof(size_t));
+        memset(totals[1], 0, (serviceTypes.count + 1) * sizeof(int64_t));
+        rollupServiceTypes(20250101, 20251231, counts[1], totals[1]);
+    }
+    double rollupSeconds = (benchNow() - start) / reads;
+    int same = memcmp(counts[0], counts[1], serviceTypes.count * sizeof(size_t)) == 0 &&
+               memcmp(totals[0], totals[1], serviceTypes.count * sizeof(int64_t)) == 0;
+    printf("%ld records\n", records);
+    printf("Revenue by type, 2025, scan:     %10.3f ms\n", scanSeconds * 1e3);
+    printf("Revenue by type, 2025, rollups:  %10.3f us (%.0fx) %s\n", rollupSeconds * 1e6,
+           scanSeconds / rollupSeconds, same ? "same totals" : "TOTAL MISMATCH");
+
+    // Revenue per owner: a pass over the columns against the owner cells
+    int64_t* ownerCents = (int64_t*)calloc(ownerNames.count + 1, sizeof(int64_t));
+    start = benchNow();
+    for (int i = 0; i < scans; i++) {
+        memset(ownerCents, 0, (ownerNames.count + 1) * sizeof(int64_t));
+        for (size_t row = 0; row < columns.count; row++) {
+            ownerCents[columns.ownerIds[row]] += columns.cents[row];
+        }
+    }
+    scanSeconds = (benchNow() - start) / scans;
+    int64_t best = 0, check = 0;
+    start = benchNow();
+    for (int i = 0; i < scans; i++) {
+        best = 0;
+        for (uint32_t id = 0; id < rollups.ownerCount; id++) {
+            if (rollups.owners[id].cents > best) best = rollups.owners[id].cents;
+        }
+    }
+    rollupSeconds = (benchNow() - start) / scans;
+    for (uint32_t id = 0; id < ownerNames.count; id++) {
+        if (ownerCents[id] > check) check = ownerCents[id];
+    }
+    printf("Top customer, column pass:       %10.3f ms\n", scanSeconds * 1e3);
+    printf("Top customer, owner cells:       %10.3f ms (%.0fx) %s\n", rollupSeconds * 1e3,
+           scanSeconds / rollupSeconds, best == check ? "same total" : "TOTAL MISMATCH");
+    free(ownerCents);
+
+    // Updates keep the rollups current; time them, then the deltas alone.
+    // Deletes walk the list to unlink, so they are left out of the timing.
+    char vehicleNumber[20], ownerName[32], date[11];
+    size_t edits = (size_t)records / 10, deletes = edits < 2000 ? edits : 2000, added = 0;
+    start = benchNow();
+    for (size_t i = 0; i < edits; i++) {
+        benchVehicleNumber(benchRand(&rng) % (uint64_t)records, vehicleNumber);
+        ServiceRecord* record = findVehicle(vehicleNumber);
+        if (record == NULL) continue;
+        snprintf(ownerName, sizeof(ownerName), "Customer %llu", (unsigned long long)(benchRand(&rng) % 1000));
+        snprintf(date, sizeof(date), "%02d-%02d-2024", (int)(benchRand(&rng) % 28) + 1,
+                 (int)(benchRand(&rng) % 12) + 1);
+        modifyRecord(record, ownerName, benchServiceTypes[benchRand(&rng) % BENCH_SERVICE_TYPES], date,
+                     (int64_t)(benchRand(&rng) % 100000));
+    }
+    double editSeconds = benchNow() - start;
+    for (size_t i = 0; i < deletes; i++) {
+        benchVehicleNumber(benchRand(&rng) % (uint64_t)records, vehicleNumber);
+        removeVehicle(&head, vehicleNumber);
+        benchInsertVehicle(&head, (uint64_t)records + added++, (uint64_t)records, &rng, 1);
+    }
+    ServiceRecord* record = head;
+    start = benchNow();
+    for (size_t i = 0; i < edits; i++) {
+        rollupApply(&rollups, record, -1);
+        rollupApply(&rollups, record, 1);
+        record = record->next != NULL ? record->next : head;
+    }
+    double deltaSeconds = benchNow() - start;
+    printf("%zu updates in %.2f s (%.2f us each), of which rollup deltas %.3f us; "
+           "then %zu deletes + %zu adds\n", edits, editSeconds, editSeconds / edits * 1e6,
+           deltaSeconds / edits * 1e6, deletes, added);
+
+    double rebuildSeconds;
+    size_t differ = checkRollups(&rebuildSeconds);
+    printf("Rebuilt from the records in %.3f s: %s\n", rebuildSeconds,
+           differ == 0 ? "consistent" : "GROUPS DIFFER");
+    for (int i = 0; i < 2; i++) {
+        free(counts[i]);
+        free(totals[i]);
+    }
+    freeList(&head);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printf("Usage: %s lsm|memory|bulkadd|cost|costindex|compaction|history|save|ops|"
+               "query|columns|scan|reminders|shared|plates|merge|shards|io|index|lazy|snapshot|"
+               "autosave|skiplist|rollups [records]\n",
+               argv[0]);
+        return 1;
+    }
+    long records = argc > 2 ? atol(argv[2]) : 0;
+
+    if (strcmp(argv[1], "lsm") == 0) {
+        benchLsm(records > 0 ? records : 200000);
+    } else if (strcmp(argv[1], "memory") == 0) {
+        benchMemory(records > 0 ? records : 100000);
+    } else if (strcmp(argv[1], "bulkadd") == 0) {
+        // Without the filter every insert walks the whole list, so keep this modest
+        long n = records > 0 ? records : 20000;
+        double without = benchBulkRegister(n, 0);
+        double with = benchBulkRegister(n, 0.01);
+        benchBulkRegister(n, 0.001);
+        printf("Speedup at 1%% FP rate: %.1fx\n", without / with);
+    } else if (strcmp(argv[1], "cost") == 0) {
+        benchCost(records > 0 ? records : 10000000);
+    } else if (strcmp(argv[1], "costindex") == 0) {
+        benchCostIndex(records > 0 ? records : 1000000);
+    } else if (strcmp(argv[1], "compaction") == 0) {
+        benchCompaction(records > 0 ? records : 1000000);
+    } else if (strcmp(argv[1], "history") == 0) {
+        benchHistory(records > 0 ? records : 1000000);
+    } else if (strcmp(argv[1], "save") == 0) {
+        benchSave(records > 0 ? records : 1000000);
+    } else if (strcmp(argv[1], "ops") == 0) {
+        benchOps(records);
+    } else if (strcmp(argv[1], "query") == 0) {
+        benchQuery(records > 0 ? records : 1000000);
+    } else if (strcmp(argv[1], "columns") == 0) {
+        benchColumns(records > 0 ? records : 1000000);
+    } else if (strcmp(argv[1], "scan") == 0) {
+        benchScan(records > 0 ? records : 2000000);
+    } else if (strcmp(argv[1], "reminders") == 0) {
+        benchReminders(records > 0 ? records : 1000000);
+    } else if (strcmp(argv[1], "shared") == 0) {
+        benchShared(records > 0 ? records : 1000000);
+    } else if (strcmp(argv[1], "plates") == 0) {
+        benchPlates(records > 0 ? records : 100000000);
+    } else if (strcmp(argv[1], "merge") == 0) {
+        benchMerge(records > 0 ? records : 2000000);
+    } else if (strcmp(argv[1], "shards") == 0) {
+        benchShards(records > 0 ? records : 1000000);
+    } else if (strcmp(argv[1], "io") == 0) {
+        benchIo(records > 0 ? records : 52000000);
+    } else if (strcmp(argv[1], "index") == 0) {
+        benchIndex(records > 0 ? records : 10000000);
+    } else if (strcmp(argv[1], "lazy") == 0) {
+        benchLazy(records > 0 ? records : 2000000);
+    } else if (strcmp(argv[1], "snapshot") == 0) {
+        benchSnapshot(records > 0 ? records : 2000000);
+    } else if (strcmp(argv[1], "autosave") == 0) {
+        benchAutosave(records > 0 ? records : 2000000);
+    } else if (strcmp(argv[1], "skiplist") == 0) {
+        benchSkipList(records > 0 ? records : 1000000);
+    } else if (strcmp(argv[1], "rollups") == 0) {
+        benchRollups(records > 0 ? records : 1000000);
+    } else {
+        printf("Unknown benchmark: %s\n", argv[1]);
+        return 1;
+    }
+    return 0;
+}